@@ -3,6 +3,7 @@
 #include <migraphx/shape.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/onnx.hpp>
+#include <migraphx/load_save.hpp>
 #include <migraphx/target.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/cpu/target.hpp>
@@ -596,3 +597,18 @@ extern "C" migraphx_status migraphx_parse_onnx_buffer(migraphx_program_t* out,
             (options == nullptr ? migraphx::onnx_options{} : migraphx::to_onnx_options(*options))));
     });
 }
+
+extern "C" migraphx_status migraphx_load(migraphx_program_t* out, const char* name)
+{
+    return migraphx::try_(
+        [&] { *out = allocate<migraphx_program_t>(migraphx::load((name))); });
+}
+
+extern "C" migraphx_status migraphx_save(const_migraphx_program_t p, const char* name)
+{
+    return migraphx::try_([&] {
+        if(p == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter p: Null pointer");
+        migraphx::save((p->object), (name));
+    });
+}
@@ -179,6 +179,10 @@ migraphx_status migraphx_parse_onnx_buffer(migraphx_program_t* out,
                                            size_t size,
                                            migraphx_onnx_options* options);
 
+migraphx_status migraphx_load(migraphx_program_t* out, const char* name);
+
+migraphx_status migraphx_save(const_migraphx_program_t p, const char* name);
+
 #ifdef __cplusplus
 }
 #endif
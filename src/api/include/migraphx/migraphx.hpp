@@ -517,6 +517,16 @@ inline program parse_onnx_buffer(const std::string& buffer)
         own{});
 }
 
+inline program load(const char* filename)
+{
+    return program(make<migraphx_program>(&migraphx_load, filename), own{});
+}
+
+inline void save(const program& p, const char* filename)
+{
+    call(&migraphx_save, p.get_handle_ptr(), filename);
+}
+
 } // namespace api
 } // namespace migraphx
 
@@ -182,3 +182,12 @@ api.add_function('migraphx_parse_onnx_buffer',
                             options='migraphx::onnx_options'),
                  fname='migraphx::parse_onnx_buffer',
                  returns='migraphx::program')
+
+api.add_function('migraphx_load',
+                 api.params(name='const char*'),
+                 fname='migraphx::load',
+                 returns='migraphx::program')
+
+api.add_function('migraphx_save',
+                 api.params(p='const migraphx::program&', name='const char*'),
+                 fname='migraphx::save')
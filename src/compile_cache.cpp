@@ -0,0 +1,184 @@
+#include <migraphx/compile_cache.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <vector>
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <utime.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE_DIR)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE_LIMIT)
+
+// Programs of a different build of the library are not reused
+static const char* const build_id = __DATE__ " " __TIME__;
+
+static const std::string& cache_extension()
+{
+    static const std::string ext = ".mxc";
+    return ext;
+}
+
+// FNV-1a
+static std::uint64_t hash_bytes(std::uint64_t h, const char* data, std::size_t n)
+{
+    for(std::size_t i = 0; i < n; i++)
+    {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+compile_cache compile_cache::from_options(const compile_options& options)
+{
+    compile_cache result;
+    result.dir = options.cache_dir;
+    if(result.dir.empty())
+        result.dir = string_value_of(MIGRAPHX_COMPILE_CACHE_DIR{});
+    result.limit = options.cache_limit;
+    if(result.limit == 0)
+        result.limit = value_of(MIGRAPHX_COMPILE_CACHE_LIMIT{}, std::size_t{4} << 30u);
+    return result;
+}
+
+bool compile_cache::enabled() const { return not dir.empty(); }
+
+std::string compile_cache::get_key(const program& p,
+                                   const target& t,
+                                   context& ctx,
+                                   const compile_options& options)
+{
+    std::ostringstream ss;
+    ss << build_id << '\n' << t.name() << '\n' << options.offload_copy << '\n';
+    for(auto&& pass : t.get_passes(ctx, options))
+        ss << pass.name() << '\n';
+    auto header = ss.str();
+    auto data   = save_buffer(p);
+    // Two hashes with different offsets make a 128-bit key
+    std::uint64_t h1 = 14695981039346656037ull;
+    std::uint64_t h2 = 7809847782465536322ull;
+    for(auto* h : {&h1, &h2})
+    {
+        *h = hash_bytes(*h, header.data(), header.size());
+        *h = hash_bytes(*h, data.data(), data.size());
+    }
+    std::ostringstream key;
+    key << std::hex << std::setfill('0') << std::setw(16) << h1 << std::setw(16) << h2;
+    return key.str();
+}
+
+std::string compile_cache::get_path(const std::string& key) const
+{
+    return dir + "/" + key + cache_extension();
+}
+
+bool compile_cache::load(const std::string& key, program& p) const
+{
+    auto path = get_path(key);
+#ifndef _WIN32
+    struct stat st = {};
+    if(stat(path.c_str(), &st) != 0)
+        return false;
+    // Mark the file as recently used
+    utime(path.c_str(), nullptr);
+#endif
+    try
+    {
+        p = migraphx::load(path);
+    }
+    catch(const std::exception&)
+    {
+        // A file that can't be read is compiled again and replaced
+        return false;
+    }
+    return true;
+}
+
+#ifndef _WIN32
+// Remove the least recently used files until the directory is under the limit
+static void evict(const std::string& dir, std::size_t limit)
+{
+    struct entry
+    {
+        std::string path;
+        std::size_t size;
+        std::time_t time;
+    };
+    std::vector<entry> entries;
+    DIR* d = opendir(dir.c_str());
+    if(d == nullptr)
+        return;
+    while(auto* e = readdir(d))
+    {
+        std::string name = e->d_name;
+        if(name.size() <= cache_extension().size() or
+           name.compare(name.size() - cache_extension().size(),
+                        cache_extension().size(),
+                        cache_extension()) != 0)
+            continue;
+        auto path      = dir + "/" + name;
+        struct stat st = {};
+        if(stat(path.c_str(), &st) == 0)
+            entries.push_back({path, std::size_t(st.st_size), st.st_mtime});
+    }
+    closedir(d);
+    std::size_t total = 0;
+    for(auto&& e : entries)
+        total += e.size;
+    std::sort(entries.begin(), entries.end(), [](const entry& x, const entry& y) {
+        return x.time < y.time;
+    });
+    for(auto&& e : entries)
+    {
+        if(total <= limit)
+            break;
+        // Another process may have removed it already
+        std::remove(e.path.c_str());
+        total -= e.size;
+    }
+}
+#endif
+
+void compile_cache::store(const std::string& key, const program& p) const
+{
+    auto path = get_path(key);
+#ifndef _WIN32
+    mkdir(dir.c_str(), 0755); // NOLINT
+#endif
+    std::random_device rd;
+    auto tmp = path + ".tmp" + std::to_string(rd());
+    try
+    {
+        save(p, tmp);
+    }
+    catch(const std::exception&)
+    {
+        std::remove(tmp.c_str());
+        return;
+    }
+    if(std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return;
+    }
+#ifndef _WIN32
+    evict(dir, limit);
+#endif
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
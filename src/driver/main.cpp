@@ -106,9 +106,10 @@ struct compiler
     static const int q_fp16 = 1;
     static const int q_int8 = 2;
     loader l;
-    bool gpu          = true;
-    bool offload_copy = false;
-    int quantize      = 0;
+    bool gpu                       = true;
+    bool offload_copy              = false;
+    int quantize                   = 0;
+    std::size_t optimization_level = 1;
 
     std::vector<std::string> fill1;
     void parse(argument_parser& ap)
@@ -120,6 +121,9 @@ struct compiler
            {"--enable-offload-copy"},
            ap.help("Enable implicit offload copying"),
            ap.set_value(false));
+        ap(optimization_level,
+           {"--optimization-level"},
+           ap.help("How much the target optimizes the program, from 0 to 2"));
         ap(quantize, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(q_fp16));
         ap(quantize, {"--int8"}, ap.help("Quantize for int8"), ap.set_value(q_int8));
         ap(fill1, {"--fill1"}, ap.help("Fill parameter with 1s"), ap.append());
@@ -148,7 +152,8 @@ struct compiler
             quantize_int8(p, t, {params(p, false)});
         }
         compile_options options;
-        options.offload_copy = offload_copy;
+        options.offload_copy       = offload_copy;
+        options.optimization_level = optimization_level;
         p.compile(t, options);
         return p;
     }
@@ -0,0 +1,198 @@
+#include <migraphx/dynamic_program.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <list>
+#include <map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct dynamic_program_impl
+{
+    using key_type = std::vector<std::size_t>;
+
+    dynamic_program::loader load;
+    target t;
+    compile_options copts;
+    dynamic_options options;
+    std::unordered_map<std::string, shape> shapes;
+    std::unordered_map<std::string, std::vector<std::string>> symbolic_dims;
+    // Sorted so the dimensions of the parameters are always in the same order in a key
+    std::vector<std::string> names;
+    // The most recently used program is at the front
+    std::list<std::pair<key_type, program>> programs;
+    std::map<key_type, std::list<std::pair<key_type, program>>::iterator> index;
+
+    bool is_symbolic(const std::string& name, std::size_t axis) const
+    {
+        auto it = symbolic_dims.find(name);
+        if(it == symbolic_dims.end() or axis >= it->second.size())
+            return false;
+        return not it->second[axis].empty();
+    }
+
+    std::size_t bucket(std::size_t n) const
+    {
+        auto it = std::lower_bound(options.buckets.begin(), options.buckets.end(), n);
+        if(it == options.buckets.end())
+            return n;
+        return *it;
+    }
+
+    // The dimensions to compile a parameter with, for an argument of shape s
+    std::vector<std::size_t> resolve(const std::string& name, const shape& s) const
+    {
+        const auto& expected = shapes.at(name);
+        if(s.type() != expected.type() or s.lens().size() != expected.lens().size())
+            MIGRAPHX_THROW("Incorrect shape {" + to_string(s) + "} for parameter: " + name);
+        auto lens = s.lens();
+        for(std::size_t i = 0; i < lens.size(); i++)
+        {
+            if(is_symbolic(name, i))
+                lens[i] = bucket(lens[i]);
+            else if(lens[i] != expected.lens()[i])
+                MIGRAPHX_THROW("Incorrect shape {" + to_string(s) + "} for parameter: " + name);
+        }
+        return lens;
+    }
+
+    const program& get(const std::unordered_map<std::string, shape>& arg_shapes)
+    {
+        key_type key;
+        input_dims dims;
+        for(auto&& name : names)
+        {
+            auto it = arg_shapes.find(name);
+            if(it == arg_shapes.end())
+                MIGRAPHX_THROW("Parameter not found: " + name);
+            auto lens = resolve(name, it->second);
+            key.insert(key.end(), lens.begin(), lens.end());
+            dims[name] = lens;
+        }
+        auto it = index.find(key);
+        if(it != index.end())
+        {
+            programs.splice(programs.begin(), programs, it->second);
+            return it->second->second;
+        }
+        auto p = load(dims);
+        p.compile(t, copts);
+        programs.emplace_front(key, std::move(p));
+        index[key] = programs.begin();
+        while(programs.size() > std::max<std::size_t>(options.capacity, 1))
+        {
+            index.erase(programs.back().first);
+            programs.pop_back();
+        }
+        return programs.front().second;
+    }
+};
+
+// Copy arg into the front of a zero filled argument of shape s
+static argument pad_argument(const argument& arg, const shape& s)
+{
+    argument result{s};
+    visit_all(result, arg)([&](auto output, auto input) {
+        shape_for_each(input.get_shape(), [&](const auto& idx) {
+            output(idx.begin(), idx.end()) = input(idx.begin(), idx.end());
+        });
+    });
+    return result;
+}
+
+// A view of the first n elements of arg along its first dimension
+static argument trim_argument(const argument& arg, std::size_t n)
+{
+    auto lens = arg.get_shape().lens();
+    lens[0]   = n;
+    shape s{arg.get_shape().type(), lens, arg.get_shape().strides()};
+    return {s, [=] { return arg.data(); }};
+}
+
+dynamic_program::dynamic_program(loader load,
+                                 target t,
+                                 compile_options copts,
+                                 dynamic_options options)
+    : impl(std::make_unique<dynamic_program_impl>())
+{
+    std::sort(options.buckets.begin(), options.buckets.end());
+    auto p = load({});
+    impl->shapes        = p.get_parameter_shapes();
+    impl->symbolic_dims = p.get_symbolic_dims();
+    std::transform(impl->shapes.begin(),
+                   impl->shapes.end(),
+                   std::back_inserter(impl->names),
+                   [](auto&& x) { return x.first; });
+    std::sort(impl->names.begin(), impl->names.end());
+    impl->load    = std::move(load);
+    impl->t       = std::move(t);
+    impl->copts   = std::move(copts);
+    impl->options = std::move(options);
+}
+
+dynamic_program::dynamic_program(dynamic_program&&) noexcept = default;
+dynamic_program& dynamic_program::operator=(dynamic_program&&) noexcept = default;
+dynamic_program::~dynamic_program() noexcept = default;
+
+std::vector<argument> dynamic_program::eval(const program::parameter_map& params)
+{
+    std::unordered_map<std::string, shape> arg_shapes;
+    for(auto&& param : params)
+        arg_shapes[param.first] = param.second.get_shape();
+    const auto& p = get_program(arg_shapes);
+
+    auto param_shapes = p.get_parameter_shapes();
+    program::parameter_map padded_params;
+    std::size_t batch        = 0;
+    std::size_t padded_batch = 0;
+    for(auto&& param : params)
+    {
+        auto it = param_shapes.find(param.first);
+        if(it == param_shapes.end() or it->second == param.second.get_shape())
+        {
+            padded_params[param.first] = param.second;
+            continue;
+        }
+        const auto& lens = param.second.get_shape().lens();
+        if(impl->is_symbolic(param.first, 0) and lens[0] != it->second.lens()[0])
+        {
+            batch        = lens[0];
+            padded_batch = it->second.lens()[0];
+        }
+        padded_params[param.first] = pad_argument(param.second, it->second);
+    }
+
+    auto results = p.eval(padded_params);
+    if(batch == padded_batch)
+        return results;
+    std::transform(results.begin(), results.end(), results.begin(), [&](const argument& r) {
+        const auto& lens = r.get_shape().lens();
+        if(lens.empty() or lens.front() != padded_batch)
+            return r;
+        return trim_argument(r, batch);
+    });
+    return results;
+}
+
+const program& dynamic_program::get_program(const std::unordered_map<std::string, shape>& shapes)
+{
+    return impl->get(shapes);
+}
+
+std::unordered_map<std::string, shape> dynamic_program::get_parameter_shapes() const
+{
+    return impl->shapes;
+}
+
+std::unordered_map<std::string, std::vector<std::string>>
+dynamic_program::get_symbolic_dims() const
+{
+    return impl->symbolic_dims;
+}
+
+std::size_t dynamic_program::size() const { return impl->programs.size(); }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
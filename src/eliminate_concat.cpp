@@ -36,7 +36,7 @@ void eliminate_concat::apply(program& p) const
         std::size_t axis_index =
             (concat_op.axis < 0) ? (concat_op.axis + lens.size()) : concat_op.axis;
         if(axis_index == 0 ||
-           std::all_of(lens.begin(), lens.begin() + concat_op.axis, [](auto x) { return x == 1; }))
+           std::all_of(lens.begin(), lens.begin() + axis_index, [](auto x) { return x == 1; }))
         {
             // Last input should be an allocation
             auto last = ins->inputs().back();
@@ -56,6 +56,18 @@ void eliminate_concat::apply(program& p) const
                }))
                 continue;
 
+            // Each input must fill its allocation in the standard layout. A
+            // transposed or sliced view of an allocation can alias it without
+            // having the layout of its slice of the concat.
+            if(not std::equal(ins->inputs().begin(),
+                              std::prev(ins->inputs().end()),
+                              allocations.begin(),
+                              [](instruction_ref x, instruction_ref alloc) {
+                                  return x->get_shape().standard() and
+                                         x->get_shape().bytes() == alloc->get_shape().bytes();
+                              }))
+                continue;
+
             // Need to sort the allocations, so that we know where to
             // insert the "super"-allocation
             std::sort(
@@ -0,0 +1,49 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_COMPILE_CACHE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_COMPILE_CACHE_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/config.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * @brief A directory of compiled programs
+ *
+ * Each program is saved in a file named after a hash of the program before it was compiled, the
+ * name of the target, its passes and the compile options. Files are written under a temporary
+ * name and renamed, so processes that share the directory never read a partial file. When the
+ * files take more than the size limit, the least recently used ones are removed.
+ */
+struct compile_cache
+{
+    std::string dir;
+    std::size_t limit = 0;
+
+    /// The cache set in the options, or by MIGRAPHX_COMPILE_CACHE_DIR and
+    /// MIGRAPHX_COMPILE_CACHE_LIMIT. It is disabled when there is no directory.
+    static compile_cache from_options(const compile_options& options);
+
+    bool enabled() const;
+
+    /// The key of program p compiled for target t with the options
+    static std::string
+    get_key(const program& p, const target& t, context& ctx, const compile_options& options);
+
+    /// The file that stores the program of a key
+    std::string get_path(const std::string& key) const;
+
+    /// Load the program of the key into p, and return false when it is not cached
+    bool load(const std::string& key, program& p) const;
+
+    /// Save the compiled program of the key, and remove old files over the limit
+    void store(const std::string& key, const program& p) const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
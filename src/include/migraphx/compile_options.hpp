@@ -3,6 +3,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/tracer.hpp>
+#include <string>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -10,7 +11,15 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct compile_options
 {
     bool offload_copy = false;
+    /// How much the target optimizes the program: 0 only lowers it, 1 also simplifies the graph
+    /// and fuses operators, and 2 also folds the parts of it that only depend on literals
+    std::size_t optimization_level = 1;
     tracer trace{};
+    /// Directory to cache compiled programs in, or MIGRAPHX_COMPILE_CACHE_DIR when empty. The
+    /// programs are not cached when neither is set.
+    std::string cache_dir = "";
+    /// Largest total size in bytes of the cached programs, or MIGRAPHX_COMPILE_CACHE_LIMIT when 0
+    std::size_t cache_limit = 0;
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -0,0 +1,75 @@
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_DYNAMIC_PROGRAM_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_DYNAMIC_PROGRAM_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/config.hpp>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct dynamic_program_impl;
+
+/// The dimensions of the parameters to parse a model with
+using input_dims = std::unordered_map<std::string, std::vector<std::size_t>>;
+
+/// struct to pass in options to a dynamic_program
+struct dynamic_options
+{
+    /// The most programs that are kept compiled, the least recently used one is dropped first
+    std::size_t capacity = 8;
+    /// Sizes, in increasing order, that a symbolic dimension is padded up to so that nearby
+    /// shapes share a program. The inputs are padded with zeros, and the outputs are cut back
+    /// along their first dimension when the batch was padded. Larger sizes are compiled as
+    /// they are, and an empty list compiles a program for every shape.
+    std::vector<std::size_t> buckets = {};
+};
+
+/**
+ * @brief Evaluates a model for inputs of any size along its symbolic dimensions
+ *
+ * The model is loaded again for each new shape of its inputs, with the dimensions passed to the
+ * loader, and compiled for the target. The compiled programs are kept for the next inputs of the
+ * same shape. A dynamic_program is not thread-safe.
+ */
+struct dynamic_program
+{
+    using loader = std::function<program(const input_dims&)>;
+
+    /// The loader is called with no dimensions to find the symbolic dimensions of the model
+    dynamic_program(loader load,
+                    target t,
+                    compile_options copts = compile_options{},
+                    dynamic_options options = dynamic_options{});
+
+    dynamic_program(dynamic_program&&) noexcept;
+    dynamic_program& operator=(dynamic_program&&) noexcept;
+    ~dynamic_program() noexcept;
+
+    std::vector<argument> eval(const program::parameter_map& params);
+
+    /// The program compiled for these shapes of the parameters, compiling it when it is not cached
+    const program& get_program(const std::unordered_map<std::string, shape>& shapes);
+
+    /// The shapes of the parameters when the model is loaded with no dimensions
+    std::unordered_map<std::string, shape> get_parameter_shapes() const;
+
+    /// The names of the symbolic dimensions of each parameter
+    std::unordered_map<std::string, std::vector<std::string>> get_symbolic_dims() const;
+
+    /// The number of compiled programs that are cached
+    std::size_t size() const;
+
+    private:
+    std::unique_ptr<dynamic_program_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -16,7 +16,9 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 /**
  * @brief Represents a raw literal
- * @details This stores the literal has a raw buffer that is owned by this class
+ * @details This stores the literal has a raw buffer that is shared by the copies of the literal and
+ * the arguments created from it. The buffer can also reference external storage, such as a mapped
+ * file, which is never copied.
  */
 struct literal : raw_data<literal>
 {
@@ -57,6 +59,10 @@ struct literal : raw_data<literal>
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Reference the data in x without copying it. The data must not be modified while the literal
+    /// or any argument created from it is alive.
+    literal(const shape& s, std::shared_ptr<char> x) : buffer(std::move(x)), m_shape(s) {}
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
@@ -65,12 +71,8 @@ struct literal : raw_data<literal>
 
     const shape& get_shape() const { return this->m_shape; }
 
-    /// Convert the data to an argument
-    argument get_argument() const
-    {
-        std::vector<char> b(buffer.get(), buffer.get() + m_shape.bytes());
-        return {m_shape, [b]() mutable { return b.data(); }};
-    }
+    /// Convert the data to an argument that shares the buffer instead of copying it
+    argument get_argument() const { return {m_shape, buffer}; }
 
     private:
     std::shared_ptr<char> buffer;
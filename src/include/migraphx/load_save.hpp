@@ -0,0 +1,36 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_LOAD_SAVE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_LOAD_SAVE_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/config.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * @brief Write a program to a file
+ * @details The file stores the instructions with the attributes of their
+ * operators, the literals and the name of the target the program was compiled
+ * for. Literal data is placed at page-aligned offsets so it can be mapped
+ * directly from the file.
+ */
+void save(const program& p, const std::string& filename);
+
+/// Read a program written by save. A compiled program is ready to run on its
+/// target without compiling it again, which requires the target to be linked
+/// in.
+program load(const std::string& filename);
+
+/// Write a program to a buffer in the same format as save
+std::vector<char> save_buffer(const program& p);
+
+/// Read a program from a buffer written by save_buffer
+program load_buffer(const std::vector<char>& buffer);
+program load_buffer(const char* buffer, std::size_t size);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
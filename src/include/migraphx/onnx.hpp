@@ -3,6 +3,8 @@
 
 #include <migraphx/program.hpp>
 #include <migraphx/config.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -10,7 +12,10 @@ inline namespace MIGRAPHX_INLINE_NS {
 /// struct to pass in onnx options to parser
 struct onnx_options
 {
+    /// Size of the dimensions the model leaves open
     unsigned int batch_size = 1;
+    /// Dimensions to use for these parameters instead of the ones in the model
+    std::unordered_map<std::string, std::vector<std::size_t>> map_input_dims = {};
 };
 
 /// Create a program from an onnx file
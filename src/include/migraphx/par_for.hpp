@@ -1,6 +1,7 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_PAR_FOR_HPP
 #define MIGRAPHX_GUARD_RTGLIB_PAR_FOR_HPP
 
+#include <migraphx/thread_pool.hpp>
 #include <thread>
 #include <cmath>
 #include <algorithm>
@@ -49,29 +50,22 @@ void par_for_impl(std::size_t n, std::size_t threadsize, F f)
     }
     else
     {
-        std::vector<joinable_thread> threads(threadsize);
 // Using const here causes gcc 5 to ICE
 #if(!defined(__GNUC__) || __GNUC__ != 5)
         const
 #endif
-            std::size_t grainsize = std::ceil(static_cast<double>(n) / threads.size());
+            std::size_t grainsize = std::ceil(static_cast<double>(n) / threadsize);
 
-        std::size_t work = 0;
-        std::size_t tid  = 0;
-        std::generate(threads.begin(), threads.end(), [=, &work, &tid] {
-            auto result = joinable_thread([=] {
-                std::size_t start = work;
-                std::size_t last  = std::min(n, work + grainsize);
-                for(std::size_t i = start; i < last; i++)
-                {
-                    thread_invoke(i, tid, f);
-                }
-            });
-            work += grainsize;
-            ++tid;
-            return result;
+        // Each tid is one task on the persistent pool, so per-thread state
+        // indexed by tid is never shared between concurrently running tasks
+        get_thread_pool().run(threadsize, 1, [&](std::size_t tid) {
+            std::size_t start = tid * grainsize;
+            std::size_t last  = std::min(n, start + grainsize);
+            for(std::size_t i = start; i < last; i++)
+            {
+                thread_invoke(i, tid, f);
+            }
         });
-        assert(work >= n);
     }
 }
 
@@ -79,7 +73,7 @@ template <class F>
 void par_for(std::size_t n, std::size_t min_grain, F f)
 {
     const auto threadsize =
-        std::min<std::size_t>(std::thread::hardware_concurrency(), n / min_grain);
+        std::min<std::size_t>(get_thread_pool().size(), n / min_grain);
     par_for_impl(n, threadsize, f);
 }
 
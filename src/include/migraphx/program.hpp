@@ -21,6 +21,8 @@ MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_COMPILE)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_EVAL)
 
 struct program_impl;
+struct session;
+struct session_impl;
 
 const operation& get_operation(instruction_ref ins);
 
@@ -95,8 +97,21 @@ struct program
 
     std::unordered_map<std::string, shape> get_parameter_shapes() const;
 
+    /// Record which dimensions of a parameter are symbolic, such as a batch size that was only
+    /// fixed when the model was parsed. dims has a name for each dimension, empty when it is fixed.
+    void set_symbolic_dims(const std::string& name, std::vector<std::string> dims);
+
+    /// The symbolic dimensions of the parameters that have any
+    std::unordered_map<std::string, std::vector<std::string>> get_symbolic_dims() const;
+
     std::vector<argument> eval(parameter_map params) const;
 
+    /// Create the state to evaluate the program from another thread. Every
+    /// session has its own context and scratch memory, while the literals and
+    /// instructions are shared, so the program must outlive its sessions and
+    /// not be modified while they are used.
+    session create_session() const;
+
     bool has_instruction(instruction_ref ins) const;
 
     std::size_t size() const;
@@ -113,6 +128,13 @@ struct program
 
     void finalize();
 
+    /// The name of the target the program was compiled for, empty if it was not compiled
+    std::string get_target_name() const;
+
+    /// Use the context of target t for a program whose instructions were already compiled for it,
+    /// such as a loaded program, and finalize its instructions
+    void set_target(const target& t);
+
     void perf_report(std::ostream& os, std::size_t n, parameter_map params) const;
 
     void debug_print() const;
@@ -136,6 +158,29 @@ struct program
     std::unique_ptr<program_impl> impl;
 };
 
+/**
+ * @brief Evaluates a compiled program with its own context
+ *
+ * A program can be evaluated concurrently by using one session per thread.
+ * A session itself is not thread-safe.
+ */
+struct session
+{
+    session(session&&) noexcept;
+    session& operator=(session&&) noexcept;
+    ~session() noexcept;
+
+    std::vector<argument> eval(program::parameter_map params);
+
+    context& get_context();
+
+    private:
+    friend struct program;
+    explicit session(std::unique_ptr<session_impl> i);
+
+    std::unique_ptr<session_impl> impl;
+};
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
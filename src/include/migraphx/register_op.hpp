@@ -0,0 +1,62 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_REGISTER_OP_HPP
+#define MIGRAPHX_GUARD_RTGLIB_REGISTER_OP_HPP
+
+#include <migraphx/operation.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/type_name.hpp>
+#include <migraphx/requires.hpp>
+#include <migraphx/config.hpp>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct op_serializer
+{
+    std::function<void(std::ostream&, const operation&)> save;
+    std::function<operation(std::istream&)> load;
+};
+
+/// Register how to serialize the operation type t. The key is written in
+/// front of every serialized operation of that type to find the serializer
+/// again when loading.
+void register_op(const std::string& key, const std::type_info& t, op_serializer s);
+
+template <class T>
+op_serializer make_op_serializer()
+{
+    return {[](std::ostream& os, const operation& op) { serialize(os, any_cast<T>(op)); },
+            [](std::istream& is) -> operation {
+                T x{};
+                deserialize(is, x);
+                return x;
+            }};
+}
+
+template <class T>
+void register_op()
+{
+    register_op(get_type_name<T>(), typeid(T), make_op_serializer<T>());
+}
+
+template <class T>
+struct op_registration
+{
+    op_registration() { register_op<T>(); }
+};
+
+// Registers an operation when the library defining it is loaded. Operations
+// in migraphx/op are registered by the core library already.
+#define MIGRAPHX_REGISTER_OP(...)                         \
+    static const migraphx::op_registration<__VA_ARGS__> \
+        MIGRAPHX_REQUIRES_CAT(migraphx_op_registration_, __LINE__){};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_REGISTER_TARGET_HPP
+#define MIGRAPHX_GUARD_RTGLIB_REGISTER_TARGET_HPP
+
+#include <migraphx/target.hpp>
+#include <migraphx/requires.hpp>
+#include <migraphx/config.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Register a target so it can be created by its name
+void register_target(const target& t);
+
+/// Create a registered target by its name
+target make_target(const std::string& name);
+
+template <class T>
+struct target_registration
+{
+    target_registration() { register_target(T{}); }
+};
+
+// Registers a target when the library defining it is loaded
+#define MIGRAPHX_REGISTER_TARGET(...)                         \
+    static const migraphx::target_registration<__VA_ARGS__> \
+        MIGRAPHX_REQUIRES_CAT(migraphx_target_registration_, __LINE__){};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -20,6 +20,12 @@ struct rewrite_rnn
     std::string name() const { return "rewrite_rnn"; }
     void apply(program& prog) const;
 
+    // The activation functions of each direction of the rnn, gru or lstm
+    // instruction, with the defaults filled in
+    std::vector<operation> vanilla_rnn_actv_funcs(instruction_ref ins) const;
+    std::vector<operation> gru_actv_funcs(instruction_ref ins) const;
+    std::vector<operation> lstm_actv_funcs(instruction_ref ins) const;
+
     private:
     // for vanilla rnn operators
     void apply_vanilla_rnn(program& prog, instruction_ref ins) const;
@@ -32,7 +38,6 @@ struct rewrite_rnn
                                                   instruction_ref bias,
                                                   instruction_ref ih,
                                                   operation& actv_func) const;
-    std::vector<operation> vanilla_rnn_actv_funcs(instruction_ref ins) const;
 
     // for gru operators
     void apply_gru(program& prog, instruction_ref ins) const;
@@ -44,8 +49,6 @@ struct rewrite_rnn
                                           const operation& actv_func1,
                                           const operation& actv_func2) const;
 
-    std::vector<operation> gru_actv_funcs(instruction_ref ins) const;
-
     // for lstm operators
     void apply_lstm(program& prog, instruction_ref ins) const;
     std::vector<instruction_ref> lstm_cell(bool is_forward,
@@ -55,8 +58,6 @@ struct rewrite_rnn
                                            const operation& actv_func1,
                                            const operation& actv_func2,
                                            const operation& actv_func3) const;
-
-    std::vector<operation> lstm_actv_funcs(instruction_ref ins) const;
 };
 
 } // namespace MIGRAPHX_INLINE_NS
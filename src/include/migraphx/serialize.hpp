@@ -0,0 +1,169 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_SERIALIZE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_SERIALIZE_HPP
+
+#include <migraphx/shape.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/requires.hpp>
+#include <migraphx/rank.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/config.hpp>
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct operation;
+
+/// Write an operation with the serializer it was registered with
+void serialize_op(std::ostream& os, const operation& op);
+/// Read an operation written by serialize_op
+operation deserialize_op(std::istream& is);
+
+template <class T>
+void serialize(std::ostream& os, const T& x);
+
+template <class T>
+void deserialize(std::istream& is, T& x);
+
+namespace detail {
+
+inline void check_stream(std::istream& is)
+{
+    if(not is)
+        MIGRAPHX_THROW("Unexpected end of serialized data");
+}
+
+inline void serialize_impl(rank<5>, std::ostream& os, const std::string& x)
+{
+    serialize(os, std::uint64_t(x.size()));
+    os.write(x.data(), x.size());
+}
+
+inline void deserialize_impl(rank<5>, std::istream& is, std::string& x)
+{
+    std::uint64_t n = 0;
+    deserialize(is, n);
+    x.resize(n);
+    is.read(&x[0], n);
+    check_stream(is);
+}
+
+template <class T, MIGRAPHX_REQUIRES(std::is_same<T, shape>{})>
+void serialize_impl(rank<4>, std::ostream& os, const T& x)
+{
+    serialize(os, x.type());
+    serialize(os, x.lens());
+    serialize(os, x.strides());
+}
+
+template <class T, MIGRAPHX_REQUIRES(std::is_same<T, shape>{})>
+void deserialize_impl(rank<4>, std::istream& is, T& x)
+{
+    shape::type_t t = shape::float_type;
+    std::vector<std::size_t> lens;
+    std::vector<std::size_t> strides;
+    deserialize(is, t);
+    deserialize(is, lens);
+    deserialize(is, strides);
+    x = shape{t, lens, strides};
+}
+
+template <class T, MIGRAPHX_REQUIRES(std::is_same<T, operation>{})>
+void serialize_impl(rank<3>, std::ostream& os, const T& x)
+{
+    serialize_op(os, x);
+}
+
+template <class T, MIGRAPHX_REQUIRES(std::is_same<T, operation>{})>
+void deserialize_impl(rank<3>, std::istream& is, T& x)
+{
+    x = deserialize_op(is);
+}
+
+template <class T, MIGRAPHX_REQUIRES(std::is_arithmetic<T>{} or std::is_enum<T>{})>
+void serialize_impl(rank<2>, std::ostream& os, const T& x)
+{
+    os.write(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+template <class T, MIGRAPHX_REQUIRES(std::is_arithmetic<T>{} or std::is_enum<T>{})>
+void deserialize_impl(rank<2>, std::istream& is, T& x)
+{
+    is.read(reinterpret_cast<char*>(&x), sizeof(T));
+    check_stream(is);
+}
+
+template <class T>
+void serialize_impl(rank<1>, std::ostream& os, const std::vector<T>& x)
+{
+    serialize(os, std::uint64_t(x.size()));
+    for(auto&& y : x)
+        serialize(os, y);
+}
+
+template <class T>
+void deserialize_impl(rank<1>, std::istream& is, std::vector<T>& x)
+{
+    std::uint64_t n = 0;
+    deserialize(is, n);
+    x.resize(n);
+    for(auto&& y : x)
+        deserialize(is, y);
+}
+
+template <class T, std::size_t N>
+void serialize_impl(rank<1>, std::ostream& os, const std::array<T, N>& x)
+{
+    for(auto&& y : x)
+        serialize(os, y);
+}
+
+template <class T, std::size_t N>
+void deserialize_impl(rank<1>, std::istream& is, std::array<T, N>& x)
+{
+    for(auto&& y : x)
+        deserialize(is, y);
+}
+
+template <class T>
+void serialize_impl(rank<0>, std::ostream& os, const T& x)
+{
+    static_assert(is_reflectable<T>{} or std::is_empty<T>{}, "Missing reflect method.");
+    reflect_each(x, [&](auto&& y, auto&&...) { serialize(os, y); });
+}
+
+template <class T>
+void deserialize_impl(rank<0>, std::istream& is, T& x)
+{
+    static_assert(is_reflectable<T>{} or std::is_empty<T>{}, "Missing reflect method.");
+    reflect_each(x, [&](auto&& y, auto&&...) { deserialize(is, y); });
+}
+
+} // namespace detail
+
+/// Write x in a binary format. Strings, shapes, operations, arithmetic types,
+/// enums, vectors and arrays are written directly, everything else is written
+/// field by field using its reflect method.
+template <class T>
+void serialize(std::ostream& os, const T& x)
+{
+    detail::serialize_impl(rank<5>{}, os, x);
+}
+
+/// Read x back from the format written by serialize
+template <class T>
+void deserialize(std::istream& is, T& x)
+{
+    detail::deserialize_impl(rank<5>{}, is, x);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
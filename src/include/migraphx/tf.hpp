@@ -3,6 +3,8 @@
 
 #include <migraphx/program.hpp>
 #include <migraphx/config.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -12,6 +14,9 @@ struct tf_options
 {
     bool is_nhwc            = false;
     unsigned int batch_size = 1;
+    /// Dimensions to use for these parameters instead of the ones in the model, in the nchw
+    /// order of the parameters of the program
+    std::unordered_map<std::string, std::vector<std::size_t>> map_input_dims = {};
 };
 
 /// Create a program from a tf pb file (default is nhwc format)
@@ -0,0 +1,58 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_THREAD_POOL_HPP
+#define MIGRAPHX_GUARD_RTGLIB_THREAD_POOL_HPP
+
+#include <migraphx/env.hpp>
+#include <migraphx/config.hpp>
+#include <functional>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_THREADS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_PIN_THREADS)
+
+struct thread_pool_impl;
+
+/**
+ * @brief A persistent pool of worker threads
+ *
+ * Each worker owns a deque of tasks. Workers pop from the front of their own
+ * deque and steal from the back of the others when they run out of work. The
+ * thread that submits work also executes tasks while it waits, so it is safe
+ * to call `run` from inside a task that is already running on the pool.
+ */
+struct thread_pool
+{
+    /// Create a pool that runs work on `n` threads, including the calling thread
+    explicit thread_pool(std::size_t n, bool pin = false);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool() noexcept;
+
+    /// Number of threads that can run work concurrently
+    std::size_t size() const;
+
+    /// Call `f(i)` for every `i` in `[0, n)`, splitting the indices into
+    /// chunks of at most `chunk` elements. Blocks until every call has
+    /// returned and rethrows the first exception thrown by `f`.
+    void run(std::size_t n, std::size_t chunk, const std::function<void(std::size_t)>& f);
+
+    /// Returns true when called from one of the pool's worker threads
+    bool is_worker() const;
+
+    private:
+    std::unique_ptr<thread_pool_impl> impl;
+};
+
+/// The process-wide pool used by `par_for`. Its size is read from
+/// MIGRAPHX_CPU_THREADS (default: hardware concurrency) and its workers are
+/// pinned to cores when MIGRAPHX_CPU_PIN_THREADS is enabled.
+thread_pool& get_thread_pool();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
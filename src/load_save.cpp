@@ -0,0 +1,245 @@
+#include <migraphx/load_save.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/make_shared_array.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// File layout:
+//   magic, version, data offset, table size
+//   table: target name, instructions (operator, shape, inputs, literal offset)
+//   data: literals, each starting at a page-aligned offset
+const char file_magic[8]        = {'M', 'I', 'G', 'R', 'A', 'P', 'H', 'X'}; // NOLINT
+const std::uint32_t file_version = 1;
+const std::uint64_t page_size    = 4096;
+const std::uint64_t header_size =
+    sizeof(file_magic) + sizeof(file_version) + 2 * sizeof(std::uint64_t);
+
+static std::uint64_t align_page(std::uint64_t n)
+{
+    return (n + page_size - 1) / page_size * page_size;
+}
+
+static void write_padding(std::ostream& os, std::uint64_t n)
+{
+    const std::vector<char> zeros(n, 0);
+    os.write(zeros.data(), zeros.size());
+}
+
+static void save_stream(const program& p, std::ostream& os)
+{
+    std::ostringstream table;
+    std::unordered_map<instruction_ref, std::uint64_t> index;
+    std::vector<instruction_ref> literals;
+    std::uint64_t data_size = 0;
+    serialize(table, p.get_target_name());
+    serialize(table, std::uint64_t(p.size()));
+    for(auto ins : iterator_for(p))
+    {
+        std::vector<std::uint64_t> inputs(ins->inputs().size());
+        std::transform(ins->inputs().begin(),
+                       ins->inputs().end(),
+                       inputs.begin(),
+                       [&](auto i) { return index.at(i); });
+        serialize(table, ins->get_operator());
+        serialize(table, ins->get_shape());
+        serialize(table, inputs);
+        if(ins->name() == "@literal")
+        {
+            serialize(table, data_size);
+            literals.push_back(ins);
+            data_size += align_page(ins->get_shape().bytes());
+        }
+        auto id    = index.size();
+        index[ins] = id;
+    }
+    auto t                    = table.str();
+    std::uint64_t data_offset = align_page(header_size + t.size());
+    os.write(file_magic, sizeof(file_magic));
+    serialize(os, file_version);
+    serialize(os, data_offset);
+    serialize(os, std::uint64_t(t.size()));
+    os.write(t.data(), t.size());
+    write_padding(os, data_offset - header_size - t.size());
+    for(auto ins : literals)
+    {
+        auto n = ins->get_shape().bytes();
+        os.write(ins->get_literal().data(), n);
+        write_padding(os, align_page(n) - n);
+    }
+    if(not os)
+        MIGRAPHX_THROW("Failed to write program");
+}
+
+// Literals reference the data in the buffer instead of copying it, so a
+// mapped file stays mapped while any of its literals are alive
+static program load_data(const std::shared_ptr<char>& data, std::size_t size)
+{
+    if(size < header_size or not std::equal(file_magic, file_magic + sizeof(file_magic), data.get()))
+        MIGRAPHX_THROW("Not a serialized program");
+    std::istringstream header(std::string(data.get(), header_size));
+    header.ignore(sizeof(file_magic));
+    std::uint32_t version     = 0;
+    std::uint64_t data_offset = 0;
+    std::uint64_t table_size  = 0;
+    deserialize(header, version);
+    if(version != file_version)
+        MIGRAPHX_THROW("Unsupported program file version: " + std::to_string(version));
+    deserialize(header, data_offset);
+    deserialize(header, table_size);
+    if(header_size + table_size > data_offset or data_offset > size)
+        MIGRAPHX_THROW("Unexpected end of serialized data");
+    std::istringstream table(std::string(data.get() + header_size, table_size));
+
+    auto get_literal = [&](const shape& s, std::uint64_t offset) {
+        if(offset > size - data_offset or s.bytes() > size - data_offset - offset)
+            MIGRAPHX_THROW("Unexpected end of literal data");
+        return literal{s, std::shared_ptr<char>(data, data.get() + data_offset + offset)};
+    };
+
+    program p;
+    std::string target_name;
+    std::uint64_t n = 0;
+    deserialize(table, target_name);
+    deserialize(table, n);
+    std::vector<instruction_ref> instructions;
+    for(std::uint64_t i = 0; i < n; i++)
+    {
+        operation op;
+        shape s;
+        std::vector<std::uint64_t> inputs;
+        deserialize(table, op);
+        deserialize(table, s);
+        deserialize(table, inputs);
+        std::vector<instruction_ref> args(inputs.size());
+        std::transform(inputs.begin(), inputs.end(), args.begin(), [&](auto j) {
+            if(j >= instructions.size())
+                MIGRAPHX_THROW("Invalid instruction input");
+            return instructions[j];
+        });
+        instruction_ref ins;
+        if(op.name() == "@literal")
+        {
+            std::uint64_t offset = 0;
+            deserialize(table, offset);
+            ins = p.move_instruction(p.add_literal(get_literal(s, offset)), p.end());
+        }
+        else if(op.name() == "@param")
+        {
+            auto&& name = any_cast<builtin::param>(op).parameter;
+            ins         = p.move_instruction(p.add_parameter(name, s), p.end());
+        }
+        else if(op.name() == "@outline")
+        {
+            ins = p.move_instruction(p.add_outline(s), p.end());
+        }
+        else if(op.name() == "@return")
+        {
+            ins = p.add_return(args);
+        }
+        else
+        {
+            ins = p.add_instruction(op, args);
+            if(ins->get_shape() != s)
+                MIGRAPHX_THROW("Shape mismatch when loading " + op.name() + ": expected {" +
+                               to_string(s) + "} but got {" + to_string(ins->get_shape()) + "}");
+        }
+        instructions.push_back(ins);
+    }
+    if(not target_name.empty())
+        p.set_target(make_target(target_name));
+    return p;
+}
+
+#ifdef _WIN32
+static std::pair<std::shared_ptr<char>, std::size_t> map_file(const std::string& filename)
+{
+    std::ifstream is(filename, std::ios::binary | std::ios::ate);
+    if(not is)
+        MIGRAPHX_THROW("Failed to open file: " + filename);
+    std::size_t size = is.tellg();
+    is.seekg(0);
+    auto data = make_shared_array<char>(size);
+    is.read(data.get(), size);
+    if(not is)
+        MIGRAPHX_THROW("Failed to read file: " + filename);
+    return {data, size};
+}
+#else
+// The file is mapped read-only, so the pages of the literals are shared with
+// every other process that loads the same file
+static std::pair<std::shared_ptr<char>, std::size_t> map_file(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY); // NOLINT
+    if(fd < 0)
+        MIGRAPHX_THROW("Failed to open file: " + filename);
+    struct stat st = {};
+    if(fstat(fd, &st) != 0 or st.st_size == 0)
+    {
+        close(fd);
+        MIGRAPHX_THROW("Failed to read file: " + filename);
+    }
+    std::size_t size = st.st_size;
+    void* m          = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(m == MAP_FAILED) // NOLINT
+        MIGRAPHX_THROW("Failed to map file: " + filename);
+    return {std::shared_ptr<char>(static_cast<char*>(m), [size](char* x) { munmap(x, size); }),
+            size};
+}
+#endif
+
+void save(const program& p, const std::string& filename)
+{
+    std::ofstream os(filename, std::ios::binary);
+    if(not os)
+        MIGRAPHX_THROW("Failed to open file for writing: " + filename);
+    save_stream(p, os);
+}
+
+program load(const std::string& filename)
+{
+    auto m = map_file(filename);
+    return load_data(m.first, m.second);
+}
+
+std::vector<char> save_buffer(const program& p)
+{
+    std::ostringstream os;
+    save_stream(p, os);
+    auto s = os.str();
+    return {s.begin(), s.end()};
+}
+
+program load_buffer(const std::vector<char>& buffer)
+{
+    return load_buffer(buffer.data(), buffer.size());
+}
+
+program load_buffer(const char* buffer, std::size_t size)
+{
+    auto data = make_shared_array<char>(size);
+    std::copy(buffer, buffer + size, data.get());
+    return load_data(data, size);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
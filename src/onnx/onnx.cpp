@@ -37,6 +37,7 @@ struct onnx_parser
     program prog            = program();
     bool is_pytorch         = false;
     unsigned int batch_size = 1;
+    std::unordered_map<std::string, std::vector<std::size_t>> map_input_dims;
 
     std::unordered_map<std::string, op_func> ops;
     std::unordered_map<std::string, operation> map_actv_funcs;
@@ -1842,9 +1843,13 @@ struct onnx_parser
             // input not in initializer_data, so it is a real input
             if(!contains(instructions, name))
             {
-                // TODO: Get shape of input parameter
-                shape s            = parse_type(input.type(), batch_size);
+                shape s = parse_type(input.type(), batch_size);
+                if(contains(map_input_dims, name))
+                    s = {s.type(), map_input_dims.at(name)};
                 instructions[name] = prog.add_parameter(name, s);
+                auto dims          = parse_symbolic_dims(input.type());
+                if(dims.size() == s.lens().size())
+                    prog.set_symbolic_dims(name, dims);
             }
         }
         for(auto&& output : graph.output())
@@ -2132,6 +2137,24 @@ struct onnx_parser
         return {shape_type, dims};
     }
 
+    // The name of each dimension that the model leaves open, and empty for the fixed ones
+    static std::vector<std::string> parse_symbolic_dims(const onnx::TypeProto& t)
+    {
+        std::vector<std::string> dims;
+        auto&& tensor_dims = t.tensor_type().shape().dim();
+        std::transform(tensor_dims.begin(),
+                       tensor_dims.end(),
+                       std::back_inserter(dims),
+                       [&](auto&& d) -> std::string {
+                           if(d.has_dim_value() and static_cast<int>(d.dim_value()) > 0)
+                               return "";
+                           if(d.has_dim_param() and not d.dim_param().empty())
+                               return d.dim_param();
+                           return "?";
+                       });
+        return dims;
+    }
+
     shape::type_t get_type(int dtype)
     {
         switch(dtype)
@@ -2167,7 +2190,8 @@ template <class... Ts>
 program parse_onnx_from(onnx_options options, Ts&&... xs)
 {
     onnx_parser parser;
-    parser.batch_size = options.batch_size;
+    parser.batch_size     = options.batch_size;
+    parser.map_input_dims = options.map_input_dims;
 #ifndef NDEBUG
     // Log the program when it can't be parsed
     try
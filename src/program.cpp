@@ -1,4 +1,5 @@
 #include <migraphx/program.hpp>
+#include <migraphx/compile_cache.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/op/identity.hpp>
@@ -11,16 +12,54 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <numeric>
 #include <utility>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// A step of the linearized program used by eval. Every instruction writes its
+// result to the slot with the same index as its step.
+struct eval_step
+{
+    enum step_kind
+    {
+        literal_step,
+        param_step,
+        outline_step,
+        compute_step
+    };
+    step_kind kind = compute_step;
+    instruction_ref ins;
+    std::string param{};
+    // Slots of the inputs of the instruction
+    std::vector<std::size_t> inputs{};
+    // Slots that are not used after this step, so they are released once it has run
+    std::vector<std::size_t> release{};
+};
+
+struct eval_plan
+{
+    std::vector<eval_step> steps{};
+    // Slots returned by eval
+    std::vector<std::size_t> outputs{};
+    std::size_t max_inputs = 0;
+};
+
+static eval_plan make_eval_plan(const program& p);
+
 struct program_impl
 {
     // A list is used to keep references to an instruction stable
     std::list<instruction> instructions;
     context ctx;
+    std::string target_name;
+    // Creates the contexts of the sessions
+    target t;
+    // Built when the program is finalized, and cleared when it is modified
+    std::shared_ptr<eval_plan> plan;
+    // Symbolic dimensions of the parameters, recorded by the parsers
+    std::unordered_map<std::string, std::vector<std::string>> symbolic_dims;
 };
 
 const operation& get_operation(instruction_ref ins) { return ins->get_operator(); }
@@ -114,7 +153,11 @@ void program::assign(const program& p)
     {
         impl->instructions.clear();
     }
-    impl->ctx = p.impl->ctx;
+    impl->ctx           = p.impl->ctx;
+    impl->target_name   = p.impl->target_name;
+    impl->t             = p.impl->t;
+    impl->plan          = nullptr;
+    impl->symbolic_dims = p.impl->symbolic_dims;
 
     std::unordered_map<instruction_ref, instruction_ref> ins_map;
     for(auto ins : iterator_for(p))
@@ -176,6 +219,7 @@ instruction_ref program::insert_instruction(instruction_ref ins,
            "Argument is not an exisiting instruction");
     assert(not starts_with(op.name(), "@"));
     shape r     = compute_shape(op, args);
+    impl->plan  = nullptr;
     auto result = impl->instructions.insert(ins, {op, r, std::move(args)});
     instruction::backreference(result);
     assert(result->valid(begin()));
@@ -191,7 +235,8 @@ instruction_ref program::replace_instruction(instruction_ref ins,
            "Argument is not an exisiting instruction");
     assert(not starts_with(op.name(), "@"));
 
-    shape r = compute_shape(op, args);
+    shape r    = compute_shape(op, args);
+    impl->plan = nullptr;
     instruction::replace(ins, op, r, std::move(args));
     assert(ins->valid(begin()));
     return ins;
@@ -202,6 +247,7 @@ instruction_ref program::replace_instruction(instruction_ref ins, instruction_re
     assert(has_instruction(ins));
     assert(has_instruction(rep));
     assert(ins != rep);
+    impl->plan = nullptr;
 
     if(ins == std::prev(this->end()))
     {
@@ -239,6 +285,7 @@ instruction_ref program::remove_instruction(instruction_ref ins)
 {
     assert(has_instruction(ins));
     assert(ins->outputs().empty());
+    impl->plan = nullptr;
     ins->clear_arguments();
     return impl->instructions.erase(ins);
 }
@@ -249,6 +296,7 @@ instruction_ref program::remove_instructions(instruction_ref first, instruction_
         return first;
     // TODO: Check every element
     assert(has_instruction(first));
+    impl->plan = nullptr;
     std::for_each(first, last, [&](instruction& ins) { ins.clear_arguments(); });
     assert(std::all_of(first, last, [&](const instruction& ins) { return ins.outputs().empty(); }));
     return impl->instructions.erase(first, last);
@@ -256,18 +304,21 @@ instruction_ref program::remove_instructions(instruction_ref first, instruction_
 
 instruction_ref program::move_instruction(instruction_ref src, instruction_ref dst)
 {
+    impl->plan = nullptr;
     impl->instructions.splice(dst, impl->instructions, src);
     return src;
 }
 
 instruction_ref program::add_literal(literal l)
 {
+    impl->plan = nullptr;
     impl->instructions.emplace_front(std::move(l));
     return impl->instructions.begin();
 }
 
 instruction_ref program::add_outline(const shape& s)
 {
+    impl->plan = nullptr;
     impl->instructions.push_front({builtin::outline{s}, s, {}});
     return impl->instructions.begin();
 }
@@ -275,6 +326,7 @@ instruction_ref program::add_outline(const shape& s)
 instruction_ref program::add_parameter(std::string name, shape s)
 {
     assert(get_parameter_shape(name) == shape{});
+    impl->plan = nullptr;
     impl->instructions.push_front({builtin::param{std::move(name)}, std::move(s), {}});
     return impl->instructions.begin();
 }
@@ -284,6 +336,7 @@ instruction_ref program::add_return(std::vector<instruction_ref> args)
     assert(std::all_of(
                args.begin(), args.end(), [&](instruction_ref x) { return has_instruction(x); }) &&
            "Argument is not an exisiting instruction");
+    impl->plan = nullptr;
     impl->instructions.push_back({builtin::returns{}, {}, args});
     auto result = std::prev(impl->instructions.end());
     instruction::backreference(result);
@@ -343,6 +396,21 @@ std::unordered_map<std::string, shape> program::get_parameter_shapes() const
     return result;
 }
 
+void program::set_symbolic_dims(const std::string& name, std::vector<std::string> dims)
+{
+    if(get_parameter_shape(name).lens().size() != dims.size())
+        MIGRAPHX_THROW("Symbolic dimensions do not match the rank of parameter: " + name);
+    if(std::all_of(dims.begin(), dims.end(), [](const std::string& d) { return d.empty(); }))
+        impl->symbolic_dims.erase(name);
+    else
+        impl->symbolic_dims[name] = std::move(dims);
+}
+
+std::unordered_map<std::string, std::vector<std::string>> program::get_symbolic_dims() const
+{
+    return impl->symbolic_dims;
+}
+
 bool program::has_instruction(instruction_ref ins) const
 {
     return std::find_if(
@@ -389,6 +457,20 @@ void program::compile(const target& t, compile_options options)
 {
     assert(this->validate() == impl->instructions.end());
     this->impl->ctx = t.get_context();
+    auto cache      = compile_cache::from_options(options);
+    std::string key;
+    if(cache.enabled())
+    {
+        key = compile_cache::get_key(*this, t, this->impl->ctx, options);
+        auto symbolic_dims = impl->symbolic_dims;
+        if(cache.load(key, *this))
+        {
+            impl->symbolic_dims = std::move(symbolic_dims);
+            return;
+        }
+    }
+    this->impl->target_name = t.name();
+    this->impl->t           = t;
     if(enabled(MIGRAPHX_TRACE_COMPILE{}))
         options.trace = tracer{std::cout};
     options.trace(*this);
@@ -401,6 +483,8 @@ void program::compile(const target& t, compile_options options)
         MIGRAPHX_THROW("Invalid program from compilation at instruction " + std::to_string(index));
     }
     this->finalize();
+    if(cache.enabled())
+        cache.store(key, *this);
 }
 
 void program::finalize()
@@ -409,73 +493,148 @@ void program::finalize()
     {
         ins->finalize(this->impl->ctx);
     }
+    this->impl->plan = std::make_shared<eval_plan>(make_eval_plan(*this));
 }
 
-template <class F>
-std::vector<argument> generic_eval(const program& p,
-                                   context& ctx,
-                                   std::unordered_map<std::string, argument> params,
-                                   F trace)
+std::string program::get_target_name() const { return impl->target_name; }
+
+void program::set_target(const target& t)
 {
-    assert(p.validate() == p.end());
-    std::unordered_map<instruction_ref, argument> results;
-    results.reserve(p.size() * 2);
-    std::vector<argument> values;
-    values.reserve(16);
+    this->impl->ctx         = t.get_context();
+    this->impl->target_name = t.name();
+    this->impl->t           = t;
+    this->finalize();
+}
+
+// Number the instructions in order, so eval can use their index instead of
+// hashing them, and find the last use of each result
+static eval_plan make_eval_plan(const program& p)
+{
+    eval_plan plan;
+    std::unordered_map<instruction_ref, std::size_t> slots;
+    slots.reserve(p.size());
+    plan.steps.reserve(p.size());
     for(auto ins : iterator_for(p))
     {
         const auto& name = ins->name();
+        std::vector<std::size_t> inputs(ins->inputs().size());
+        std::transform(ins->inputs().begin(),
+                       ins->inputs().end(),
+                       inputs.begin(),
+                       [&](instruction_ref i) { return slots.at(i); });
+        if(name == "@return")
+        {
+            plan.outputs = inputs;
+            break;
+        }
+        eval_step step;
+        step.ins    = ins;
+        step.inputs = std::move(inputs);
         if(name == "@literal")
         {
-            results.emplace(ins, trace(ins, [&] { return ins->get_literal().get_argument(); }));
+            step.kind = eval_step::literal_step;
         }
         else if(name == "@param")
         {
-            results.emplace(
-                ins, trace(ins, [&] {
-                    auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
-                    if(not contains(params, param_name))
-                        MIGRAPHX_THROW("Parameter not found: " + param_name);
-                    auto param = params[param_name];
-                    if(param.get_shape() != ins->get_shape())
-                        MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
-                                       "} for parameter: " + param_name);
-                    return param;
-                }));
+            step.kind  = eval_step::param_step;
+            step.param = any_cast<builtin::param>(ins->get_operator()).parameter;
         }
         else if(name == "@outline")
         {
-            results.emplace(ins, trace(ins, [&] { return argument{ins->get_shape(), nullptr}; }));
-        }
-        else if(name == "@return")
-        {
-            std::vector<argument> prog_outputs;
-            std::transform(ins->inputs().begin(),
-                           ins->inputs().end(),
-                           std::back_inserter(prog_outputs),
-                           [&](instruction_ref i) {
-                               assert(results.find(i) != results.end());
-                               return results[i];
-                           });
-
-            return prog_outputs;
+            step.kind = eval_step::outline_step;
         }
-        else
+        plan.max_inputs = std::max(plan.max_inputs, step.inputs.size());
+        slots.emplace(ins, plan.steps.size());
+        plan.steps.push_back(std::move(step));
+    }
+    if(plan.outputs.empty() and not plan.steps.empty())
+        plan.outputs = {plan.steps.size() - 1};
+
+    const std::size_t keep = plan.steps.size();
+    std::vector<std::size_t> last_use(plan.steps.size());
+    std::iota(last_use.begin(), last_use.end(), 0);
+    for(std::size_t i = 0; i < plan.steps.size(); i++)
+    {
+        for(auto j : plan.steps[i].inputs)
+            last_use[j] = i;
+    }
+    for(auto j : plan.outputs)
+        last_use[j] = keep;
+    for(std::size_t j = 0; j < last_use.size(); j++)
+    {
+        if(last_use[j] != keep)
+            plan.steps[last_use[j]].release.push_back(j);
+    }
+    return plan;
+}
+
+template <class F>
+std::vector<argument> generic_eval(const program& p,
+                                   const eval_plan& plan,
+                                   context& ctx,
+                                   std::unordered_map<std::string, argument> params,
+                                   F trace)
+{
+    assert(p.validate() == p.end());
+    (void)p;
+    std::vector<argument> results(plan.steps.size());
+    std::vector<argument> values;
+    values.reserve(plan.max_inputs);
+    for(std::size_t i = 0; i < plan.steps.size(); i++)
+    {
+        const auto& step = plan.steps[i];
+        auto ins         = step.ins;
+        switch(step.kind)
         {
-            values.resize(ins->inputs().size());
-            std::transform(
-                ins->inputs().begin(), ins->inputs().end(), values.begin(), [&](instruction_ref i) {
-                    assert(results.find(i) != results.end());
-                    return results[i];
-                });
-            results.emplace(ins, trace(ins, [&] {
-                                return ins->get_operator().compute(ctx, ins->get_shape(), values);
-                            }));
+        case eval_step::literal_step:
+            results[i] = trace(ins, [&] { return ins->get_literal().get_argument(); });
+            break;
+        case eval_step::param_step:
+            results[i] = trace(ins, [&] {
+                auto it = params.find(step.param);
+                if(it == params.end())
+                    MIGRAPHX_THROW("Parameter not found: " + step.param);
+                auto param = it->second;
+                if(param.get_shape() != ins->get_shape())
+                    MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
+                                   "} for parameter: " + step.param);
+                return param;
+            });
+            break;
+        case eval_step::outline_step:
+            results[i] = trace(ins, [&] { return argument{ins->get_shape(), nullptr}; });
+            break;
+        case eval_step::compute_step:
+            values.resize(step.inputs.size());
+            std::transform(step.inputs.begin(),
+                           step.inputs.end(),
+                           values.begin(),
+                           [&](std::size_t j) { return results[j]; });
+            results[i] = trace(
+                ins, [&] { return ins->get_operator().compute(ctx, ins->get_shape(), values); });
+            break;
         }
-        assert(results.find(ins) != results.end());
+        for(auto j : step.release)
+            results[j] = argument{};
     }
+    std::vector<argument> outputs(plan.outputs.size());
+    std::transform(plan.outputs.begin(),
+                   plan.outputs.end(),
+                   outputs.begin(),
+                   [&](std::size_t j) { return results[j]; });
+    return outputs;
+}
 
-    return {results.at(std::prev(p.end()))};
+template <class F>
+std::vector<argument> generic_eval(const program& p,
+                                   const std::shared_ptr<eval_plan>& plan,
+                                   context& ctx,
+                                   std::unordered_map<std::string, argument> params,
+                                   F trace)
+{
+    if(plan)
+        return generic_eval(p, *plan, ctx, std::move(params), trace);
+    return generic_eval(p, make_eval_plan(p), ctx, std::move(params), trace);
 }
 
 std::vector<argument> program::eval(parameter_map params) const
@@ -497,7 +656,7 @@ std::vector<argument> program::eval(parameter_map params) const
 
     if(trace_level > 0)
     {
-        return generic_eval(*this, ctx, std::move(params), [&](auto& ins, auto f) {
+        return generic_eval(*this, impl->plan, ctx, std::move(params), [&](auto& ins, auto f) {
             ctx.finish();
             std::cout << "Run instruction: ";
             this->debug_print(ins);
@@ -510,11 +669,60 @@ std::vector<argument> program::eval(parameter_map params) const
     }
     else
     {
-        return generic_eval(
-            *this, ctx, std::move(params), [&](auto&, auto f) { return check_context(f); });
+        return generic_eval(*this, impl->plan, ctx, std::move(params), [&](auto&, auto f) {
+            return check_context(f);
+        });
     }
 }
 
+struct session_impl
+{
+    const program* prog = nullptr;
+    std::shared_ptr<eval_plan> plan;
+    context ctx;
+};
+
+session program::create_session() const
+{
+    auto s  = std::make_unique<session_impl>();
+    s->prog = this;
+    s->plan = impl->plan ? impl->plan : std::make_shared<eval_plan>(make_eval_plan(*this));
+    if(impl->target_name.empty())
+    {
+        s->ctx = impl->ctx;
+    }
+    else
+    {
+        // The finalizers allocate the state of an operator in the context,
+        // and copies of the operators are used so the program is unchanged
+        s->ctx = impl->t.get_context();
+        for(auto ins : iterator_for(*this))
+        {
+            auto op = ins->get_operator();
+            if(has_finalize(op))
+                op.finalize(s->ctx, ins->get_shape(), to_shapes(ins->inputs()));
+        }
+    }
+    return session{std::move(s)};
+}
+
+session::session(std::unique_ptr<session_impl> i) : impl(std::move(i)) {}
+
+session::session(session&&) noexcept = default;
+
+session& session::operator=(session&&) noexcept = default;
+
+session::~session() noexcept = default;
+
+std::vector<argument> session::eval(program::parameter_map params)
+{
+    return generic_eval(*impl->prog, *impl->plan, impl->ctx, std::move(params), [](auto&, auto f) {
+        return f();
+    });
+}
+
+context& session::get_context() { return impl->ctx; }
+
 double common_average(const std::vector<double>& v)
 {
     std::size_t n = v.size() / 4;
@@ -542,14 +750,14 @@ void program::perf_report(std::ostream& os, std::size_t n, parameter_map params)
     std::sort(total_vec.begin(), total_vec.end());
     std::unordered_map<instruction_ref, std::vector<double>> ins_vec;
     // Fill the map
-    generic_eval(*this, ctx, params, [&](auto ins, auto) {
+    generic_eval(*this, impl->plan, ctx, params, [&](auto ins, auto) {
         ins_vec[ins].reserve(n);
         return argument{};
     });
     // Run and time each instruction
     for(std::size_t i = 0; i < n; i++)
     {
-        generic_eval(*this, ctx, params, [&](auto ins, auto f) {
+        generic_eval(*this, impl->plan, ctx, params, [&](auto ins, auto f) {
             argument result;
             ins_vec[ins].push_back(time<milliseconds>([&] {
                 result = f();
@@ -784,7 +992,7 @@ void program::print_cpp(std::ostream& os) const
 void program::dry_run(std::unordered_map<std::string, argument> params) const
 {
     auto& ctx = this->impl->ctx;
-    generic_eval(*this, ctx, std::move(params), [](auto&&...) { return argument{}; });
+    generic_eval(*this, impl->plan, ctx, std::move(params), [](auto&&...) { return argument{}; });
 }
 
 void program::annotate(std::ostream& os, std::function<void(instruction_ref)> a) const
@@ -2,6 +2,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <migraphx/program.hpp>
+#include <migraphx/load_save.hpp>
 #include <migraphx/quantization.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/cpu/target.hpp>
@@ -160,33 +161,59 @@ PYBIND11_MODULE(migraphx, m)
         .def("get_parameter_shapes", &migraphx::program::get_parameter_shapes)
         .def("get_output_shapes", &migraphx::program::get_output_shapes)
         .def("compile",
-             [](migraphx::program& p, const migraphx::target& t, bool offload_copy) {
+             [](migraphx::program& p,
+                const migraphx::target& t,
+                bool offload_copy,
+                std::size_t optimization_level) {
                  migraphx::compile_options options;
-                 options.offload_copy = offload_copy;
+                 options.offload_copy       = offload_copy;
+                 options.optimization_level = optimization_level;
                  p.compile(t, options);
              },
              py::arg("t"),
-             py::arg("offload_copy") = true)
+             py::arg("offload_copy")       = true,
+             py::arg("optimization_level") = 1)
         .def("run", &migraphx::program::eval)
         .def("__eq__", std::equal_to<migraphx::program>{})
         .def("__ne__", std::not_equal_to<migraphx::program>{})
         .def("__repr__", [](const migraphx::program& p) { return migraphx::to_string(p); });
 
     m.def("parse_tf",
-          [](const std::string& filename, bool is_nhwc, unsigned int batch_size) {
-              return migraphx::parse_tf(filename, migraphx::tf_options{is_nhwc, batch_size});
+          [](const std::string& filename,
+             bool is_nhwc,
+             unsigned int batch_size,
+             std::unordered_map<std::string, std::vector<std::size_t>> map_input_dims) {
+              return migraphx::parse_tf(
+                  filename, migraphx::tf_options{is_nhwc, batch_size, map_input_dims});
           },
           "Parse tf protobuf (default format is nhwc)",
           py::arg("filename"),
-          py::arg("is_nhwc")    = true,
-          py::arg("batch_size") = 1);
+          py::arg("is_nhwc")        = true,
+          py::arg("batch_size")     = 1,
+          py::arg("map_input_dims") = std::unordered_map<std::string, std::vector<std::size_t>>());
     m.def("parse_onnx",
-          [](const std::string& filename, unsigned int batch_size) {
-              return migraphx::parse_onnx(filename, migraphx::onnx_options{batch_size});
+          [](const std::string& filename,
+             unsigned int batch_size,
+             std::unordered_map<std::string, std::vector<std::size_t>> map_input_dims) {
+              return migraphx::parse_onnx(filename,
+                                          migraphx::onnx_options{batch_size, map_input_dims});
           },
           "Parse onnx file",
           py::arg("filename"),
-          py::arg("batch_size") = 1);
+          py::arg("batch_size")     = 1,
+          py::arg("map_input_dims") = std::unordered_map<std::string, std::vector<std::size_t>>());
+
+    m.def("save",
+          [](const migraphx::program& p, const std::string& filename) {
+              migraphx::save(p, filename);
+          },
+          "Save a program to a file",
+          py::arg("p"),
+          py::arg("filename"));
+    m.def("load",
+          [](const std::string& filename) { return migraphx::load(filename); },
+          "Load a program saved with save",
+          py::arg("filename"));
 
     m.def("get_target", [](const std::string& name) -> migraphx::target {
         if(name == "cpu")
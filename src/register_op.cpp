@@ -0,0 +1,178 @@
+#include <migraphx/register_op.hpp>
+#include <migraphx/operators.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/functional.hpp>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct op_registry
+{
+    std::unordered_map<std::string, op_serializer> serializers{};
+    std::unordered_map<std::type_index, std::string> keys{};
+    std::mutex m{};
+
+    // The operators of the core library are registered when the registry is
+    // first used, so they do not depend on the order of static initialization
+    op_registry()
+    {
+        add_ops<builtin::literal,
+                builtin::outline,
+                builtin::param,
+                builtin::returns,
+                op::abs,
+                op::acos,
+                op::acosh,
+                op::add,
+                op::argmax,
+                op::argmin,
+                op::as_shape,
+                op::asin,
+                op::asinh,
+                op::atan,
+                op::atanh,
+                op::batch_norm_inference,
+                op::broadcast,
+                op::capture,
+                op::ceil,
+                op::clip,
+                op::concat,
+                op::contiguous,
+                op::convert,
+                op::convolution,
+                op::cos,
+                op::cosh,
+                op::deconvolution,
+                op::div,
+                op::dot,
+                op::elu,
+                op::erf,
+                op::exp,
+                op::flatten,
+                op::floor,
+                op::gather,
+                op::gru,
+                op::identity,
+                op::im2col,
+                op::leaky_relu,
+                op::load,
+                op::log,
+                op::logsoftmax,
+                op::lrn,
+                op::lstm,
+                op::lstm_last_cell_output,
+                op::max,
+                op::min,
+                op::mul,
+                op::multibroadcast,
+                op::neg,
+                op::outline,
+                op::pad,
+                op::pooling,
+                op::pow,
+                op::prelu,
+                op::quant_convolution,
+                op::quant_dot,
+                op::recip,
+                op::reduce_max,
+                op::reduce_mean,
+                op::reduce_min,
+                op::reduce_prod,
+                op::reduce_sum,
+                op::relu,
+                op::reshape,
+                op::rnn,
+                op::rnn_last_output,
+                op::round,
+                op::rsqrt,
+                op::scalar,
+                op::sigmoid,
+                op::sign,
+                op::sin,
+                op::sinh,
+                op::slice,
+                op::softmax,
+                op::sqdiff,
+                op::sqrt,
+                op::squeeze,
+                op::sub,
+                op::tan,
+                op::tanh,
+                op::transpose,
+                op::undefined,
+                op::unknown,
+                op::unsqueeze>();
+    }
+
+    void add(const std::string& key, const std::type_info& t, op_serializer s)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        serializers[key] = std::move(s);
+        keys[t]          = key;
+    }
+
+    template <class... Ts>
+    void add_ops()
+    {
+        each_args(
+            [&](auto x) {
+                this->add(get_type_name(x), typeid(x), make_op_serializer<decltype(x)>());
+            },
+            Ts{}...);
+    }
+
+    std::pair<std::string, op_serializer> find(const std::type_info& t)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        auto it = keys.find(t);
+        if(it == keys.end())
+            return {};
+        return {it->second, serializers.at(it->second)};
+    }
+
+    op_serializer find(const std::string& key)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        auto it = serializers.find(key);
+        if(it == serializers.end())
+            return {};
+        return it->second;
+    }
+};
+
+static op_registry& get_op_registry()
+{
+    static op_registry r{};
+    return r;
+}
+
+void register_op(const std::string& key, const std::type_info& t, op_serializer s)
+{
+    get_op_registry().add(key, t, std::move(s));
+}
+
+void serialize_op(std::ostream& os, const operation& op)
+{
+    auto r = get_op_registry().find(op.type_id());
+    if(not r.second.save)
+        MIGRAPHX_THROW("Operator is not registered for serialization: " + op.name());
+    serialize(os, r.first);
+    r.second.save(os, op);
+}
+
+operation deserialize_op(std::istream& is)
+{
+    std::string key;
+    deserialize(is, key);
+    auto s = get_op_registry().find(key);
+    if(not s.load)
+        MIGRAPHX_THROW("Unknown operator: " + key);
+    return s.load(is);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,39 @@
+#include <migraphx/register_target.hpp>
+#include <migraphx/errors.hpp>
+#include <mutex>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct target_registry
+{
+    std::unordered_map<std::string, target> targets{};
+    std::mutex m{};
+};
+
+static target_registry& get_target_registry()
+{
+    static target_registry r{};
+    return r;
+}
+
+void register_target(const target& t)
+{
+    auto& r = get_target_registry();
+    std::lock_guard<std::mutex> lock(r.m);
+    r.targets[t.name()] = t;
+}
+
+target make_target(const std::string& name)
+{
+    auto& r = get_target_registry();
+    std::lock_guard<std::mutex> lock(r.m);
+    auto it = r.targets.find(name);
+    if(it == r.targets.end())
+        MIGRAPHX_THROW("Unknown target: " + name);
+    return it->second;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -382,8 +382,7 @@ struct stream_info
         conflict_table_type conflict_table;
         auto concur_ins = this->find_concurrent_instructions(p);
 
-        std::vector<conflict_table_type> thread_conflict_tables(
-            std::thread::hardware_concurrency());
+        std::vector<conflict_table_type> thread_conflict_tables(get_thread_pool().size());
         std::vector<instruction_ref> index_to_ins;
         index_to_ins.reserve(concur_ins.size());
         std::transform(concur_ins.begin(),
@@ -2,8 +2,16 @@
 #include <migraphx/program.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/op/as_shape.hpp>
+#include <migraphx/op/broadcast.hpp>
 #include <migraphx/op/transpose.hpp>
 #include <migraphx/op/concat.hpp>
+#include <migraphx/op/logsoftmax.hpp>
+#include <migraphx/op/reduce_max.hpp>
+#include <migraphx/op/reduce_mean.hpp>
+#include <migraphx/op/reduce_min.hpp>
+#include <migraphx/op/reduce_prod.hpp>
+#include <migraphx/op/reduce_sum.hpp>
+#include <migraphx/op/softmax.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/matcher.hpp>
@@ -55,6 +63,81 @@ bool is_no_transpose(const std::vector<int64_t>& dims)
                dims.begin(), dims.end(), [](auto x, auto y) { return (y - x) != 1; }) == dims.end();
 }
 
+const auto& pointwise_names()
+{
+    // clang-format off
+    static const std::unordered_set<std::string> names = {
+        "abs", "acos", "acosh", "add", "asin", "asinh", "atan", "atanh", "ceil", "clip",
+        "convert", "cos", "cosh", "div", "elu", "erf", "exp", "floor", "leaky_relu", "log",
+        "max", "min", "mul", "neg", "pow", "prelu", "recip", "relu", "round", "rsqrt",
+        "sigmoid", "sign", "sin", "sinh", "sqdiff", "sqrt", "sub", "tan", "tanh"
+    };
+    // clang-format on
+    return names;
+}
+
+// The layout of the program output is kept, so no transpose is moved past it
+bool is_program_output(const program& p, instruction_ref ins)
+{
+    return ins == std::prev(p.end()) or
+           std::any_of(ins->outputs().begin(), ins->outputs().end(), [](auto out) {
+               return out->name() == "@return";
+           });
+}
+
+// The transpose that ins is, or that ins is a contiguous copy of
+instruction_ref skip_contiguous_transpose(instruction_ref ins)
+{
+    if(ins->name() == "contiguous" and ins->inputs().front()->name() == "transpose")
+        return ins->inputs().front();
+    return ins;
+}
+
+// Replaces the axes of a reduction or softmax over a transpose with the
+// dims, with the axes of the input of the transpose
+struct remap_axes
+{
+    const std::vector<int64_t>& dims;
+    operation& result;
+
+    int64_t remap(int64_t axis) const
+    {
+        if(axis < 0)
+            axis += dims.size();
+        return dims[axis];
+    }
+
+    template <class Op>
+    bool reduce() const
+    {
+        if(result.name() != Op{}.name())
+            return false;
+        auto r = any_cast<Op>(result);
+        std::transform(
+            r.axes.begin(), r.axes.end(), r.axes.begin(), [&](auto a) { return remap(a); });
+        result = r;
+        return true;
+    }
+
+    template <class Op>
+    bool softmax() const
+    {
+        if(result.name() != Op{}.name())
+            return false;
+        auto r = any_cast<Op>(result);
+        r.axis = remap(r.axis);
+        result = r;
+        return true;
+    }
+
+    bool apply() const
+    {
+        return reduce<op::reduce_max>() or reduce<op::reduce_mean>() or
+               reduce<op::reduce_min>() or reduce<op::reduce_prod>() or
+               reduce<op::reduce_sum>() or softmax<op::softmax>() or softmax<op::logsoftmax>();
+    }
+};
+
 struct find_reshaper
 {
     auto matcher() const
@@ -179,6 +262,97 @@ struct find_concat_transpose
     }
 };
 
+// Pointwise operators over inputs transposed the same way are computed
+// before the transpose, so it can meet and cancel the next one. Broadcasted
+// inputs are transposed back, which is only a different view of them, and a
+// 1d broadcast is replaced by one along the axis it is transposed to.
+struct find_pointwise_transpose
+{
+    auto matcher() const
+    {
+        return match::name(pointwise_names())(
+            match::any_of[match::inputs()](match::name("transpose", "contiguous")));
+    }
+
+    void apply(program& p, const match::matcher_result& mr) const
+    {
+        auto ins = mr.result;
+        if(is_program_output(p, ins))
+            return;
+        std::vector<int64_t> dims;
+        for(auto input : ins->inputs())
+        {
+            auto t = skip_contiguous_transpose(input);
+            if(t->name() == "transpose")
+            {
+                if(dims.empty())
+                    dims = get_transpose_dims(t);
+                else if(dims != get_transpose_dims(t))
+                    return;
+            }
+            else if(not input->get_shape().broadcasted() and not input->get_shape().scalar())
+            {
+                return;
+            }
+        }
+        if(dims.empty())
+            return;
+        auto idims = invert_permutation(dims);
+        std::vector<instruction_ref> inputs;
+        std::transform(
+            ins->inputs().begin(), ins->inputs().end(), std::back_inserter(inputs), [&](auto i) {
+                auto t = skip_contiguous_transpose(i);
+                if(t->name() == "transpose")
+                    return t->inputs().front();
+                // A bias is broadcasted along the axis it ends up on instead
+                if(i->name() == "broadcast" and
+                   i->inputs().front()->get_shape().lens().size() == 1 and
+                   i->inputs().front()->get_shape().elements() > 1)
+                {
+                    auto b = any_cast<op::broadcast>(i->get_operator());
+                    return p.insert_instruction(
+                        ins,
+                        op::broadcast{static_cast<uint64_t>(dims[b.axis]),
+                                      reorder_dims(b.broadcast_lens, idims)},
+                        i->inputs().front());
+                }
+                return p.insert_instruction(ins, op::transpose{idims}, i);
+            });
+        auto pointwise = p.insert_instruction(ins, ins->get_operator(), inputs);
+        p.replace_instruction(ins, op::transpose{dims}, pointwise);
+    }
+};
+
+// A reduction or softmax of a transpose is computed on its input, with the
+// axes mapped to the ones of the input, and transposed afterwards
+struct find_reduce_transpose
+{
+    auto matcher() const
+    {
+        return match::name("reduce_max",
+                           "reduce_mean",
+                           "reduce_min",
+                           "reduce_prod",
+                           "reduce_sum",
+                           "softmax",
+                           "logsoftmax")(match::arg(0)(match::name("transpose", "contiguous")));
+    }
+
+    void apply(program& p, const match::matcher_result& mr) const
+    {
+        auto ins = mr.result;
+        auto t   = skip_contiguous_transpose(ins->inputs().front());
+        if(t->name() != "transpose" or is_program_output(p, ins))
+            return;
+        auto dims = get_transpose_dims(t);
+        auto rop  = ins->get_operator();
+        if(not remap_axes{dims, rop}.apply())
+            return;
+        auto reduce = p.insert_instruction(ins, rop, t->inputs().front());
+        p.replace_instruction(ins, op::transpose{dims}, reduce);
+    }
+};
+
 struct find_nested_concat
 {
     auto matcher() const
@@ -229,6 +403,8 @@ void simplify_reshapes::apply(program& p) const
                                 find_reshaper{},
                                 find_transpose{},
                                 find_concat_transpose{},
+                                find_pointwise_transpose{},
+                                find_reduce_transpose{},
                                 find_nested_concat{});
         }
     }
@@ -0,0 +1,27 @@
+#include <migraphx/cpu/allocate.hpp>
+#include <migraphx/register_op.hpp>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+argument allocate_aligned(const shape& s, std::size_t alignment)
+{
+    assert(alignment > 0 and (alignment & (alignment - 1)) == 0);
+    std::shared_ptr<char> buffer(new char[s.bytes() + alignment], std::default_delete<char[]>());
+    auto addr    = reinterpret_cast<std::uintptr_t>(buffer.get());
+    auto aligned = (addr + alignment - 1) & ~(alignment - 1);
+    auto offset  = aligned - addr;
+    return {s, [buffer, offset] { return buffer.get() + offset; }};
+}
+
+MIGRAPHX_REGISTER_OP(cpu_allocate)
+MIGRAPHX_REGISTER_OP(cpu_load_memory)
+MIGRAPHX_REGISTER_OP(cpu_copy)
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,75 @@
+#include <migraphx/cpu/concat.hpp>
+#include <migraphx/cpu/copy.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/register_op.hpp>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Bytes copied by one task
+constexpr std::size_t concat_grain = 64 * 1024;
+
+void concat(const argument& output, const std::vector<argument>& inputs, std::size_t axis)
+{
+    const auto& out_shape = output.get_shape();
+    const auto& lens      = out_shape.lens();
+    std::size_t outer     = std::accumulate(
+        lens.begin(), lens.begin() + axis, std::size_t{1}, std::multiplies<std::size_t>{});
+    std::size_t inner = std::accumulate(
+        lens.begin() + axis + 1, lens.end(), std::size_t{1}, std::multiplies<std::size_t>{});
+    std::size_t type_size = out_shape.type_size();
+    // The offset of each input in a slab of the output
+    std::vector<std::size_t> offsets(inputs.size() + 1, 0);
+    for(std::size_t i = 0; i < inputs.size(); i++)
+        offsets[i + 1] = offsets[i] + inputs[i].get_shape().lens()[axis] * inner * type_size;
+    std::size_t slab = offsets.back();
+    if(outer * slab == 0)
+        return;
+
+    if(not out_shape.standard() or std::any_of(inputs.begin(), inputs.end(), [](auto&& x) {
+           return not x.get_shape().standard();
+       }))
+    {
+        // Copy each input into its view of the output with its strides
+        for(std::size_t i = 0; i < inputs.size(); i++)
+        {
+            auto in_lens = inputs[i].get_shape().lens();
+            shape view{out_shape.type(), in_lens, out_shape.strides()};
+            std::size_t offset = offsets[i] / (inner * type_size) * out_shape.strides()[axis];
+            strided_copy({view, output.data() + offset * type_size}, inputs[i]);
+        }
+        return;
+    }
+
+    char* out = output.data();
+    std::vector<const char*> in(inputs.size());
+    std::transform(
+        inputs.begin(), inputs.end(), in.begin(), [](auto&& x) -> const char* { return x.data(); });
+    std::size_t grain = std::max<std::size_t>(1, concat_grain * inputs.size() / slab);
+    par_for(outer * inputs.size(), grain, [&](auto j) {
+        std::size_t o = j / inputs.size();
+        std::size_t i = j % inputs.size();
+        std::size_t n = offsets[i + 1] - offsets[i];
+        std::memcpy(out + o * slab + offsets[i], in[i] + o * n, n);
+    });
+}
+
+argument cpu_concat::compute(context&, const shape&, std::vector<argument> args) const
+{
+    argument result = args.back();
+    args.pop_back();
+    auto n = result.get_shape().lens().size();
+    concat(result, args, (op.axis < 0) ? op.axis + n : op.axis);
+    return result;
+}
+
+MIGRAPHX_REGISTER_OP(cpu_concat)
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,577 @@
+#include <migraphx/cpu/convolution.hpp>
+#include <migraphx/cpu/gemm.hpp>
+#include <migraphx/dfor.hpp>
+#include <migraphx/par_dfor.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+std::string to_string(conv_algorithm algo)
+{
+    switch(algo)
+    {
+    case conv_algorithm::naive: return "naive";
+    case conv_algorithm::direct: return "direct";
+    case conv_algorithm::gemm: return "gemm";
+    case conv_algorithm::im2col: return "im2col";
+    case conv_algorithm::nhwc: return "nhwc";
+    }
+    MIGRAPHX_THROW("Unknown convolution algorithm");
+}
+
+bool is_channels_last(const shape& s)
+{
+    if(s.lens().size() != 4 or s.broadcasted())
+        return false;
+    return s.strides() == make_channels_last(s).strides();
+}
+
+shape make_channels_last(const shape& s)
+{
+    const auto& l = s.lens();
+    assert(l.size() == 4);
+    return {s.type(), l, {l[1] * l[2] * l[3], 1, l[3] * l[1], l[1]}};
+}
+
+shape conv_output_shape(const shape& output, const shape& allocation)
+{
+    if(allocation.type() == output.type() and allocation.lens() == output.lens() and
+       is_channels_last(allocation))
+        return allocation;
+    return output;
+}
+
+struct conv_dims
+{
+    std::size_t n;
+    std::size_t c;
+    std::size_t h;
+    std::size_t w;
+    std::size_t k;
+    std::size_t kh;
+    std::size_t kw;
+    std::size_t oh;
+    std::size_t ow;
+    std::size_t group;
+    // Input and output channels per group
+    std::size_t cg;
+    std::size_t kg;
+
+    conv_dims(const conv_params& params,
+              const shape& output,
+              const shape& input,
+              const shape& weights)
+        : n(input.lens()[0]),
+          c(input.lens()[1]),
+          h(input.lens()[2]),
+          w(input.lens()[3]),
+          k(weights.lens()[0]),
+          kh(weights.lens()[2]),
+          kw(weights.lens()[3]),
+          oh(output.lens()[2]),
+          ow(output.lens()[3]),
+          group(params.group),
+          cg(weights.lens()[1]),
+          kg(weights.lens()[0] / params.group)
+    {
+    }
+};
+
+// Adds the bias of a channel and applies the activation to the output values
+template <class T>
+struct conv_output
+{
+    const T* bias           = nullptr;
+    std::size_t bias_stride = 0;
+    bool relu               = false;
+
+    conv_output(const conv_epilogue& e) : relu(e.relu)
+    {
+        if(e.bias.empty())
+            return;
+        bias        = reinterpret_cast<const T*>(e.bias.data());
+        bias_stride = e.bias.get_shape().strides()[1];
+    }
+
+    bool empty() const { return bias == nullptr and not relu; }
+
+    T operator()(T x, std::size_t k) const
+    {
+        if(bias != nullptr)
+            x = T(x + bias[k * bias_stride]);
+        if(relu)
+            return std::max(T{0}, x);
+        return x;
+    }
+
+    // Store n values of channel k from src into dst
+    void store(T* dst, const T* src, std::size_t n, std::size_t k) const
+    {
+        if(this->empty())
+            std::copy(src, src + n, dst);
+        else
+            std::transform(src, src + n, dst, [&](T x) { return (*this)(x, k); });
+    }
+
+    // Apply to the planes of n values of the channels [k0, k0 + nk) in place
+    void apply(T* out, std::size_t n, std::size_t k0, std::size_t nk) const
+    {
+        if(this->empty())
+            return;
+        par_for(nk, [&](std::size_t kk) {
+            T* x = out + kk * n;
+            this->store(x, x, n, k0 + kk);
+        });
+    }
+};
+
+static std::ptrdiff_t ceil_div(std::ptrdiff_t x, std::ptrdiff_t y) { return (x + y - 1) / y; }
+
+template <class T, class U>
+static void conv_naive(const conv_params& params,
+                       const conv_output<T>& post,
+                       tensor_view<T> output,
+                       tensor_view<U> input,
+                       tensor_view<U> weights)
+{
+    auto in_h  = static_cast<std::ptrdiff_t>(input.get_shape().lens()[2]);
+    auto in_w  = static_cast<std::ptrdiff_t>(input.get_shape().lens()[3]);
+    auto wei   = weights.get_shape().lens();
+    auto wei_n = wei[0];
+    auto wei_c = wei[1];
+    auto wei_h = wei[2];
+    auto wei_w = wei[3];
+
+    auto out_lens = output.get_shape().lens();
+    par_dfor(out_lens[0], out_lens[1], out_lens[2], out_lens[3])(
+        [&](std::size_t o, std::size_t w, std::size_t i, std::size_t j) {
+            const auto start_x  = std::ptrdiff_t(i * params.stride[0] - params.padding[0]);
+            const auto start_y  = std::ptrdiff_t(j * params.stride[1] - params.padding[1]);
+            const auto group_id = w / (wei_n / params.group);
+
+            T acc = T{0};
+            dfor(wei_c, wei_h, wei_w)([&](std::size_t k, std::size_t x, std::size_t y) {
+                const auto in_x  = start_x + std::ptrdiff_t(x * params.dilation[0]);
+                const auto in_y  = start_y + std::ptrdiff_t(y * params.dilation[1]);
+                const auto in_ch = group_id * wei_c + k;
+                if(in_x >= 0 && in_x < in_h && in_y >= 0 && in_y < in_w)
+                    acc += input(o, in_ch, in_x, in_y) * weights(w, k, x, y);
+            });
+            output(o, w, i, j) = post(acc, w);
+        });
+}
+
+// Computes a block of output channels for one output row at a time. The
+// accumulators for the whole row stay in a small per-thread buffer, and the
+// innermost loop runs over contiguous output pixels so it can be vectorized.
+// When KH and KW are non-zero the kernel size is known at compile time and
+// the filter loops are fully unrolled.
+template <std::size_t KH, std::size_t KW, class T, class U>
+static void conv_direct(const conv_params& params,
+                        const conv_output<T>& post,
+                        const conv_dims& d,
+                        T* out,
+                        const U* in,
+                        const U* wei)
+{
+    const std::size_t kblock = 4;
+    const std::size_t kh     = KH == 0 ? d.kh : KH;
+    const std::size_t kw     = KW == 0 ? d.kw : KW;
+    const auto sh            = static_cast<std::ptrdiff_t>(params.stride[0]);
+    const auto sw            = static_cast<std::ptrdiff_t>(params.stride[1]);
+    const auto nkb           = (d.kg + kblock - 1) / kblock;
+    const auto ih_max        = static_cast<std::ptrdiff_t>(d.h);
+    const auto iw_max        = static_cast<std::ptrdiff_t>(d.w);
+    const auto ow_max        = static_cast<std::ptrdiff_t>(d.ow);
+
+    std::vector<std::vector<T>> buffers(get_thread_pool().size(),
+                                        std::vector<T>(kblock * d.ow));
+    par_for(d.n * d.group * nkb * d.oh, [&](std::size_t idx, std::size_t tid) {
+        const auto oh = idx % d.oh;
+        idx /= d.oh;
+        const auto kb = idx % nkb;
+        idx /= nkb;
+        const auto g  = idx % d.group;
+        const auto ni = idx / d.group;
+        const auto k0 = g * d.kg + kb * kblock;
+        const auto nk = std::min(kblock, d.kg - kb * kblock);
+
+        T* acc = buffers[tid].data();
+        std::fill(acc, acc + kblock * d.ow, T{0});
+        for(std::size_t c = 0; c < d.cg; c++)
+        {
+            const U* in_c = in + (ni * d.c + g * d.cg + c) * d.h * d.w;
+            for(std::size_t y = 0; y < kh; y++)
+            {
+                const auto ih = std::ptrdiff_t(oh) * sh +
+                                std::ptrdiff_t(y * params.dilation[0] - params.padding[0]);
+                if(ih < 0 or ih >= ih_max)
+                    continue;
+                const U* in_row = in_c + ih * d.w;
+                for(std::size_t x = 0; x < kw; x++)
+                {
+                    // Only output pixels that read inside the input row contribute
+                    const auto off = std::ptrdiff_t(x * params.dilation[1] - params.padding[1]);
+                    const auto lo  = off >= 0 ? 0 : ceil_div(-off, sw);
+                    const auto hi =
+                        iw_max - off <= 0 ? 0 : std::min(ow_max, ceil_div(iw_max - off, sw));
+                    for(std::size_t kk = 0; kk < nk; kk++)
+                    {
+                        const T wv = T(wei[(((k0 + kk) * d.cg + c) * kh + y) * kw + x]);
+                        T* acc_k   = acc + kk * d.ow;
+                        if(sw == 1)
+                        {
+                            const U* src = in_row + off;
+                            for(auto ow = lo; ow < hi; ow++)
+                                acc_k[ow] += wv * T(src[ow]);
+                        }
+                        else
+                        {
+                            for(auto ow = lo; ow < hi; ow++)
+                                acc_k[ow] += wv * T(in_row[ow * sw + off]);
+                        }
+                    }
+                }
+            }
+        }
+        for(std::size_t kk = 0; kk < nk; kk++)
+        {
+            post.store(out + ((ni * d.k + k0 + kk) * d.oh + oh) * d.ow,
+                       acc + kk * d.ow,
+                       d.ow,
+                       k0 + kk);
+        }
+    });
+}
+
+// Each task computes one output row of a group, one pixel at a time. The
+// weights are packed so the output channels of a group are innermost, and
+// the accumulators of a pixel are updated with a contiguous loop over them.
+// The input and output are read through their strides, so a channels last
+// tensor is read with unit stride along the channels.
+template <class T, class U>
+static void conv_nhwc(const conv_params& params,
+                      const conv_output<T>& post,
+                      const conv_dims& d,
+                      tensor_view<T> output,
+                      tensor_view<U> input,
+                      const U* wei)
+{
+    const auto& is    = input.get_shape().strides();
+    const auto& os    = output.get_shape().strides();
+    const auto ih_max = static_cast<std::ptrdiff_t>(d.h);
+    const auto iw_max = static_cast<std::ptrdiff_t>(d.w);
+    const auto kk_max = d.kh * d.kw;
+
+    // Packed as [group][y][x][c][k]
+    std::vector<U> packed(d.group * kk_max * d.cg * d.kg);
+    par_for(d.k, [&](std::size_t k) {
+        const auto g  = k / d.kg;
+        const auto kk = k % d.kg;
+        for(std::size_t c = 0; c < d.cg; c++)
+        {
+            for(std::size_t yx = 0; yx < kk_max; yx++)
+                packed[((g * kk_max + yx) * d.cg + c) * d.kg + kk] =
+                    wei[(k * d.cg + c) * kk_max + yx];
+        }
+    });
+
+    std::vector<std::vector<T>> buffers(get_thread_pool().size(), std::vector<T>(d.kg));
+    par_for(d.n * d.group * d.oh, [&](std::size_t idx, std::size_t tid) {
+        const auto oh = idx % d.oh;
+        idx /= d.oh;
+        const auto g  = idx % d.group;
+        const auto ni = idx / d.group;
+
+        T* acc     = buffers[tid].data();
+        const U* x = input.data() + ni * is[0] + g * d.cg * is[1];
+        T* y       = output.data() + ni * os[0] + g * d.kg * os[1] + oh * os[2];
+        for(std::size_t ow = 0; ow < d.ow; ow++)
+        {
+            std::fill(acc, acc + d.kg, T{0});
+            for(std::size_t fy = 0; fy < d.kh; fy++)
+            {
+                const auto ih = std::ptrdiff_t(oh * params.stride[0] + fy * params.dilation[0]) -
+                                std::ptrdiff_t(params.padding[0]);
+                if(ih < 0 or ih >= ih_max)
+                    continue;
+                for(std::size_t fx = 0; fx < d.kw; fx++)
+                {
+                    const auto iw =
+                        std::ptrdiff_t(ow * params.stride[1] + fx * params.dilation[1]) -
+                        std::ptrdiff_t(params.padding[1]);
+                    if(iw < 0 or iw >= iw_max)
+                        continue;
+                    const U* px = x + ih * is[2] + iw * is[3];
+                    const U* w  = packed.data() + (g * kk_max + fy * d.kw + fx) * d.cg * d.kg;
+                    for(std::size_t c = 0; c < d.cg; c++)
+                    {
+                        const T v    = T(px[c * is[1]]);
+                        const U* w_c = w + c * d.kg;
+                        for(std::size_t kk = 0; kk < d.kg; kk++)
+                            acc[kk] += v * T(w_c[kk]);
+                    }
+                }
+            }
+            T* out = y + ow * os[3];
+            for(std::size_t kk = 0; kk < d.kg; kk++)
+                out[kk * os[1]] = post(acc[kk], g * d.kg + kk);
+        }
+    });
+}
+
+// Computes c = a * b where c is m x n, a is m x k and b is k x n. The columns
+// of c are split into blocks that are multiplied in parallel.
+template <class T, class U>
+static void gemm_columns(T* c,
+                         const U* a,
+                         const U* b,
+                         std::size_t m,
+                         std::size_t n,
+                         std::size_t k,
+                         std::size_t ldb,
+                         std::size_t ldc)
+{
+    const shape::type_t c_type  = shape::get_type<T>{};
+    const shape::type_t a_type  = shape::get_type<U>{};
+    const std::size_t min_block = 64;
+    const std::size_t nblock =
+        std::max(min_block, (n + get_thread_pool().size() - 1) / get_thread_pool().size());
+    const std::size_t nblocks = (n + nblock - 1) / nblock;
+    par_for(nblocks, 1, [&](std::size_t i) {
+        const auto j0 = i * nblock;
+        const auto nc = std::min(nblock, n - j0);
+        argument c_arg{shape{c_type, {m, nc}, {ldc, 1}}, c + j0};
+        argument a_arg{shape{a_type, {m, k}}, const_cast<U*>(a)};               // NOLINT
+        argument b_arg{shape{a_type, {k, nc}, {ldb, 1}}, const_cast<U*>(b + j0)}; // NOLINT
+        migemm(c_arg, a_arg, b_arg, T{1}, T{0});
+    });
+}
+
+template <class T, class U>
+static void
+conv_gemm(const conv_output<T>& post, const conv_dims& d, T* out, const U* in, const U* wei)
+{
+    const auto hw = d.h * d.w;
+    for(std::size_t ni = 0; ni < d.n; ni++)
+    {
+        for(std::size_t g = 0; g < d.group; g++)
+        {
+            gemm_columns(out + (ni * d.k + g * d.kg) * hw,
+                         wei + g * d.kg * d.cg,
+                         in + (ni * d.c + g * d.cg) * hw,
+                         d.kg,
+                         hw,
+                         d.cg,
+                         hw,
+                         hw);
+            post.apply(out + (ni * d.k + g * d.kg) * hw, hw, g * d.kg, d.kg);
+        }
+    }
+}
+
+template <class T, class U>
+static void conv_im2col(const conv_params& params,
+                        const conv_output<T>& post,
+                        const conv_dims& d,
+                        T* out,
+                        const U* in,
+                        const U* wei)
+{
+    const auto ohw    = d.oh * d.ow;
+    const auto rows   = d.cg * d.kh * d.kw;
+    const auto ih_max = static_cast<std::ptrdiff_t>(d.h);
+    const auto iw_max = static_cast<std::ptrdiff_t>(d.w);
+    std::vector<U> col(rows * ohw);
+    for(std::size_t ni = 0; ni < d.n; ni++)
+    {
+        for(std::size_t g = 0; g < d.group; g++)
+        {
+            par_for(rows, [&](std::size_t r) {
+                const auto c    = r / (d.kh * d.kw);
+                const auto y    = (r / d.kw) % d.kh;
+                const auto x    = r % d.kw;
+                U* dst          = col.data() + r * ohw;
+                const auto* src = in + (ni * d.c + g * d.cg + c) * d.h * d.w;
+                for(std::size_t oh = 0; oh < d.oh; oh++)
+                {
+                    const auto ih = std::ptrdiff_t(oh * params.stride[0] +
+                                                   y * params.dilation[0] - params.padding[0]);
+                    U* dst_row = dst + oh * d.ow;
+                    if(ih < 0 or ih >= ih_max)
+                    {
+                        std::fill(dst_row, dst_row + d.ow, U{0});
+                        continue;
+                    }
+                    for(std::size_t ow = 0; ow < d.ow; ow++)
+                    {
+                        const auto iw = std::ptrdiff_t(ow * params.stride[1] +
+                                                       x * params.dilation[1] - params.padding[1]);
+                        dst_row[ow] = (iw >= 0 and iw < iw_max) ? src[ih * d.w + iw] : U{0};
+                    }
+                }
+            });
+            gemm_columns(out + (ni * d.k + g * d.kg) * ohw,
+                         wei + g * d.kg * rows,
+                         col.data(),
+                         d.kg,
+                         ohw,
+                         rows,
+                         ohw,
+                         ohw);
+            post.apply(out + (ni * d.k + g * d.kg) * ohw, ohw, g * d.kg, d.kg);
+        }
+    }
+}
+
+// The gemm based algorithms need a migemm that accumulates U into T, which is
+// float into float or int8 into int32
+template <class T, class U>
+struct has_conv_gemm : std::false_type
+{
+};
+
+template <>
+struct has_conv_gemm<float, float> : std::true_type
+{
+};
+
+template <>
+struct has_conv_gemm<int32_t, int8_t> : std::true_type
+{
+};
+
+template <class T, class U>
+static void conv_run_gemm(const conv_params& params,
+                          conv_algorithm algo,
+                          const conv_output<T>& post,
+                          const conv_dims& d,
+                          T* out,
+                          const U* in,
+                          const U* wei,
+                          std::true_type)
+{
+    if(algo == conv_algorithm::gemm)
+        conv_gemm(post, d, out, in, wei);
+    else
+        conv_im2col(params, post, d, out, in, wei);
+}
+
+template <class T, class U>
+static void conv_run_gemm(const conv_params&,
+                          conv_algorithm algo,
+                          const conv_output<T>&,
+                          const conv_dims&,
+                          T*,
+                          const U*,
+                          const U*,
+                          std::false_type)
+{
+    MIGRAPHX_THROW("conv2d: " + to_string(algo) + " is not supported for this type");
+}
+
+template <class T, class U>
+static void conv_run(const conv_params& params,
+                     conv_algorithm algo,
+                     const conv_epilogue& epilogue,
+                     tensor_view<T> output,
+                     tensor_view<U> input,
+                     tensor_view<U> weights)
+{
+    conv_output<T> post{epilogue};
+    if(algo == conv_algorithm::naive)
+    {
+        conv_naive(params, post, output, input, weights);
+        return;
+    }
+    conv_dims d{params, output.get_shape(), input.get_shape(), weights.get_shape()};
+    if(algo == conv_algorithm::nhwc)
+        conv_nhwc(params, post, d, output, input, weights.data());
+    else if(algo == conv_algorithm::gemm or algo == conv_algorithm::im2col)
+        conv_run_gemm(params,
+                      algo,
+                      post,
+                      d,
+                      output.data(),
+                      input.data(),
+                      weights.data(),
+                      has_conv_gemm<T, U>{});
+    else if(d.kh == 3 and d.kw == 3)
+        conv_direct<3, 3>(params, post, d, output.data(), input.data(), weights.data());
+    else if(d.kh == 1 and d.kw == 1)
+        conv_direct<1, 1>(params, post, d, output.data(), input.data(), weights.data());
+    else
+        conv_direct<0, 0>(params, post, d, output.data(), input.data(), weights.data());
+}
+
+conv_algorithm select_conv_algorithm(const conv_params& params,
+                                     const shape& output,
+                                     const shape& input,
+                                     const shape& weights)
+{
+    // Any packed layout is supported by the nhwc kernel, but it is only
+    // faster than the others when one of the tensors is channels last
+    if(weights.standard() and input.packed() and output.packed() and
+       (is_channels_last(input) or is_channels_last(output)) and
+       not(input.standard() and output.standard()))
+        return conv_algorithm::nhwc;
+    if(not(output.standard() and input.standard() and weights.standard()))
+        return conv_algorithm::naive;
+    const bool float_conv =
+        output.type() == shape::float_type and input.type() == shape::float_type;
+    const bool int8_conv = output.type() == shape::int32_type and input.type() == shape::int8_type;
+    if(not float_conv and not int8_conv)
+        return conv_algorithm::direct;
+    auto kh = weights.lens()[2];
+    auto kw = weights.lens()[3];
+    if(kh == 1 and kw == 1 and params.stride == std::array<std::size_t, 2>{{1, 1}} and
+       params.padding == std::array<std::size_t, 2>{{0, 0}})
+        return conv_algorithm::gemm;
+    // Depthwise and small filters do too little work per input pixel to pay
+    // for the extra memory traffic of im2col
+    if(params.group == input.lens()[1] or (kh <= 3 and kw <= 3))
+        return conv_algorithm::direct;
+    return conv_algorithm::im2col;
+}
+
+void conv2d(const conv_params& params,
+            conv_algorithm algo,
+            const argument& result,
+            const argument& input,
+            const argument& weights,
+            const conv_epilogue& epilogue)
+{
+    if(not epilogue.bias.empty() and epilogue.bias.get_shape().type() != result.get_shape().type())
+        MIGRAPHX_THROW("conv2d: bias type does not match the output type");
+    if(result.get_shape().type() == input.get_shape().type())
+    {
+        visit_all(result, input, weights)([&](auto output, auto x, auto w) {
+            conv_run(params, algo, epilogue, output, x, w);
+        });
+    }
+    else if(result.get_shape().type() == shape::int32_type and
+            input.get_shape().type() == shape::int8_type)
+    {
+        conv_run(params,
+                 algo,
+                 epilogue,
+                 result.get<int32_t>(),
+                 input.get<int8_t>(),
+                 weights.get<int8_t>());
+    }
+    else
+    {
+        MIGRAPHX_THROW("conv2d: unsupported type combination");
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,163 @@
+#include <migraphx/cpu/copy.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Bytes copied by one task
+constexpr std::size_t copy_grain = 64 * 1024;
+// Elements along each side of a tile of a transpose
+constexpr std::size_t copy_tile = 32;
+
+struct copy_dim
+{
+    std::size_t len;
+    std::size_t out_stride;
+    std::size_t in_stride;
+};
+
+// The dimensions of the copy, outermost first, without dimensions of 1 and
+// with the ones that are contiguous in both tensors merged
+static std::vector<copy_dim> collapse_copy_dims(const shape& output, const shape& input)
+{
+    const auto& lens = output.lens();
+    std::vector<copy_dim> dims;
+    for(std::size_t d = lens.size(); d > 0; d--)
+    {
+        auto len = lens[d - 1];
+        if(len == 1)
+            continue;
+        copy_dim dim{len, output.strides()[d - 1], input.strides()[d - 1]};
+        if(not dims.empty())
+        {
+            auto& inner = dims.back();
+            if(dim.out_stride == inner.out_stride * inner.len and
+               dim.in_stride == inner.in_stride * inner.len)
+            {
+                inner.len *= len;
+                continue;
+            }
+        }
+        dims.push_back(dim);
+    }
+    if(dims.empty())
+        dims.push_back({1, 1, 1});
+    std::reverse(dims.begin(), dims.end());
+    return dims;
+}
+
+static std::size_t elements(const std::vector<copy_dim>& dims)
+{
+    return std::accumulate(dims.begin(), dims.end(), std::size_t{1}, [](auto n, auto&& d) {
+        return n * d.len;
+    });
+}
+
+// Offsets of the i-th element of the dimensions in the output and the input
+static void offsets_of(const std::vector<copy_dim>& dims,
+                       std::size_t i,
+                       std::size_t& out_offset,
+                       std::size_t& in_offset)
+{
+    for(auto it = dims.rbegin(); it != dims.rend(); ++it)
+    {
+        std::size_t idx = i % it->len;
+        i /= it->len;
+        out_offset += idx * it->out_stride;
+        in_offset += idx * it->in_stride;
+    }
+}
+
+template <class T>
+static void copy_impl(std::vector<copy_dim> dims, T* out, const T* in)
+{
+    auto inner = dims.back();
+    dims.pop_back();
+    std::size_t rows = elements(dims);
+
+    // Contiguous runs in both tensors
+    if(inner.out_stride == 1 and inner.in_stride == 1)
+    {
+        // A single run is split in chunks
+        std::size_t chunk = std::max<std::size_t>(1, copy_grain / sizeof(T));
+        if(rows == 1)
+        {
+            std::size_t chunks = (inner.len + chunk - 1) / chunk;
+            par_for(chunks, 1, [&](auto i) {
+                std::size_t start = i * chunk;
+                std::size_t n     = std::min(chunk, inner.len - start);
+                std::memcpy(out + start, in + start, n * sizeof(T));
+            });
+            return;
+        }
+        par_for(rows, std::max<std::size_t>(1, chunk / inner.len), [&](auto i) {
+            std::size_t out_offset = 0;
+            std::size_t in_offset  = 0;
+            offsets_of(dims, i, out_offset, in_offset);
+            std::memcpy(out + out_offset, in + in_offset, inner.len * sizeof(T));
+        });
+        return;
+    }
+
+    // The dimension that is innermost in the input, when it is another one
+    // than the innermost of the output
+    auto it = std::find_if(dims.begin(), dims.end(), [](auto&& d) { return d.in_stride == 1; });
+    if(inner.out_stride == 1 and it != dims.end())
+    {
+        auto outer = *it;
+        dims.erase(it);
+        std::size_t batch  = elements(dims);
+        std::size_t itiles = (inner.len + copy_tile - 1) / copy_tile;
+        std::size_t otiles = (outer.len + copy_tile - 1) / copy_tile;
+        std::size_t grain =
+            std::max<std::size_t>(1, copy_grain / (copy_tile * copy_tile * sizeof(T)));
+        par_for(batch * otiles * itiles, grain, [&](auto i) {
+            std::size_t i0         = (i % itiles) * copy_tile;
+            std::size_t o0         = ((i / itiles) % otiles) * copy_tile;
+            std::size_t out_offset = 0;
+            std::size_t in_offset  = 0;
+            offsets_of(dims, i / (itiles * otiles), out_offset, in_offset);
+            std::size_t i1 = std::min(inner.len, i0 + copy_tile);
+            std::size_t o1 = std::min(outer.len, o0 + copy_tile);
+            for(std::size_t o = o0; o < o1; o++)
+            {
+                T* y       = out + out_offset + o * outer.out_stride;
+                const T* x = in + in_offset + o;
+                for(std::size_t j = i0; j < i1; j++)
+                    y[j] = x[j * inner.in_stride];
+            }
+        });
+        return;
+    }
+
+    // Any other strides are copied one row of the innermost dimension at a time
+    par_for(rows, std::max<std::size_t>(1, copy_grain / (inner.len * sizeof(T))), [&](auto i) {
+        std::size_t out_offset = 0;
+        std::size_t in_offset  = 0;
+        offsets_of(dims, i, out_offset, in_offset);
+        T* y       = out + out_offset;
+        const T* x = in + in_offset;
+        for(std::size_t j = 0; j < inner.len; j++)
+            y[j * inner.out_stride] = x[j * inner.in_stride];
+    });
+}
+
+void strided_copy(const argument& output, const argument& input)
+{
+    if(output.get_shape().lens() != input.get_shape().lens())
+        MIGRAPHX_THROW("strided_copy: the lens of the output and input are different");
+    if(output.get_shape().elements() == 0)
+        return;
+    auto dims = collapse_copy_dims(output.get_shape(), input.get_shape());
+    visit_all(output, input)([&](auto out, auto in) { copy_impl(dims, out.data(), in.data()); });
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
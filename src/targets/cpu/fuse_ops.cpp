@@ -0,0 +1,419 @@
+#include <migraphx/cpu/fuse_ops.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/convolution.hpp>
+#include <migraphx/cpu/gemm.hpp>
+#include <migraphx/cpu/pointwise.hpp>
+#include <migraphx/matcher.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/op/convolution.hpp>
+#include <migraphx/op/dot.hpp>
+#include <migraphx/op/relu.hpp>
+#include <array>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+template <bool Relu>
+struct cpu_conv_bias
+{
+    op::convolution op;
+    conv_algorithm algo = conv_algorithm::naive;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return Relu ? "cpu::conv_bias_relu" : "cpu::conv_bias"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs, *this}.has(4);
+        return conv_output_shape(op.compute_shape({inputs.at(0), inputs.at(1)}), inputs.at(3));
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    void finalize(context&, const shape& output_shape, const std::vector<shape>& inputs)
+    {
+        algo = select_conv_algorithm(conv_params::from(op), output_shape, inputs[0], inputs[1]);
+    }
+    argument compute(context&, const shape&, const std::vector<argument>& args) const
+    {
+        conv2d(conv_params::from(op), algo, args[3], args[0], args[1], {args[2], Relu});
+        return args[3];
+    }
+};
+
+template <bool Relu>
+struct cpu_dot_bias
+{
+    op::dot op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return Relu ? "cpu::dot_bias_relu" : "cpu::dot_bias"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs, *this}.has(4);
+        return op.compute_shape({inputs.at(0), inputs.at(1)});
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    argument compute(context&, const shape&, const std::vector<argument>& args) const
+    {
+        argument result = args[3];
+        // The bias is accumulated into by the gemm, like the c matrix of a dot
+        visit_all(result, args[2])([&](auto output, auto bias) {
+            pointwise([](auto x) { return x; }, output, bias);
+        });
+        migemm(result, args[0], args[1], op.alpha, 1.0f);
+        if(Relu)
+        {
+            result.visit([&](auto output) { pointwise(op::relu{}.apply(), output, output); });
+        }
+        return result;
+    }
+};
+
+struct cpu_fused_pointwise
+{
+    // Names of the operators in pointwise_ops, in the order they are computed
+    std::vector<std::string> ops;
+    // The arguments of each operator one after the other. Indices below the
+    // number of inputs refer to an input, and the ones after refer to the
+    // result of an earlier operator.
+    std::vector<std::size_t> op_args;
+    std::vector<pointwise_kernel> kernels;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.ops, "ops"), f(self.op_args, "op_args"));
+    }
+
+    std::string name() const { return "cpu::fused_pointwise"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs, *this}.same_dims();
+        if(inputs.size() < 2)
+            MIGRAPHX_THROW("cpu::fused_pointwise: no inputs");
+        return inputs.back();
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+
+    std::vector<pointwise_kernel> get_kernels(shape::type_t t) const
+    {
+        std::vector<pointwise_kernel> result(ops.size());
+        std::transform(ops.begin(), ops.end(), result.begin(), [&](const std::string& name) {
+            auto k = get_pointwise_kernel(name, t);
+            if(k.run == nullptr)
+                MIGRAPHX_THROW("cpu::fused_pointwise: unsupported operator " + name);
+            return k;
+        });
+        return result;
+    }
+
+    void finalize(context&, const shape& output_shape, const std::vector<shape>&)
+    {
+        kernels = get_kernels(output_shape.type());
+    }
+
+    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    {
+        argument result = args.back();
+        args.pop_back();
+        auto ks                 = kernels.empty() ? get_kernels(output_shape.type()) : kernels;
+        const std::size_t n     = args.size();
+        const std::size_t bytes = output_shape.type_size() * pointwise_block_size;
+        std::vector<shape> shapes{result.get_shape()};
+        std::transform(args.begin(), args.end(), std::back_inserter(shapes), [](const auto& a) {
+            return a.get_shape();
+        });
+
+        // Every thread keeps the result of each operator, but the last, for
+        // one block, which stays in the L1 cache
+        struct scratch
+        {
+            std::vector<char> buffer;
+            std::vector<char*> data;
+            std::vector<std::size_t> strides;
+        };
+        std::vector<scratch> scratches(get_thread_pool().size());
+        for(auto& s : scratches)
+        {
+            s.buffer.resize((ops.size() - 1) * bytes);
+            s.data.resize(n + ops.size());
+            s.strides.resize(n + ops.size(), 1);
+        }
+        auto run_block = [&](std::size_t tid,
+                             std::size_t m,
+                             const std::size_t* offsets,
+                             const std::size_t* strides) {
+            auto& s = scratches[tid];
+            for(std::size_t i = 0; i < n; i++)
+            {
+                s.data[i]    = args[i].data() + offsets[i + 1] * shapes[i + 1].type_size();
+                s.strides[i] = strides[i + 1];
+            }
+            for(std::size_t i = 0; i + 1 < ops.size(); i++)
+                s.data[n + i] = s.buffer.data() + i * bytes;
+            s.data.back()    = result.data() + offsets[0] * output_shape.type_size();
+            s.strides.back() = strides[0];
+
+            auto arg = op_args.begin();
+            for(std::size_t i = 0; i < ks.size(); i++)
+            {
+                std::array<char*, 3> data{{s.data[n + i]}};
+                std::array<std::size_t, 3> step{{s.strides[n + i]}};
+                for(std::size_t j = 0; j < ks[i].inputs; j++, ++arg)
+                {
+                    data[j + 1] = s.data[*arg];
+                    step[j + 1] = s.strides[*arg];
+                }
+                ks[i].run(m, data.data(), step.data());
+            }
+        };
+        pointwise_blocks(shapes, run_block);
+        return result;
+    }
+};
+
+MIGRAPHX_REGISTER_OP(cpu_conv_bias<false>)
+MIGRAPHX_REGISTER_OP(cpu_conv_bias<true>)
+MIGRAPHX_REGISTER_OP(cpu_dot_bias<false>)
+MIGRAPHX_REGISTER_OP(cpu_dot_bias<true>)
+MIGRAPHX_REGISTER_OP(cpu_fused_pointwise)
+
+// The operators read their inputs with any strides, so a broadcast made
+// contiguous by auto_contiguous is read directly instead
+static instruction_ref skip_contiguous(instruction_ref ins)
+{
+    if(ins->name() == "cpu::contiguous" and ins->inputs().front()->get_shape().broadcasted())
+        return ins->inputs().front();
+    return ins;
+}
+
+MIGRAPHX_PRED_MATCHER(broadcast_contiguous, instruction_ref ins)
+{
+    return skip_contiguous(ins) != ins;
+}
+
+// Broadcasted on every dimension except the channels of a nchw tensor
+MIGRAPHX_PRED_MATCHER(bias_shape, instruction_ref ins)
+{
+    auto&& s = skip_contiguous(ins)->get_shape();
+    return s.broadcasted() and s.strides().size() == 4 and s.strides()[0] == 0 and
+           s.strides()[1] != 0 and s.strides()[2] == 0 and s.strides()[3] == 0;
+}
+
+MIGRAPHX_PRED_MATCHER(fusable_conv, instruction_ref ins)
+{
+    return ins->name() == "cpu::convolution" and ins->get_shape().lens().size() == 4;
+}
+
+MIGRAPHX_PRED_MATCHER(fusable_dot, instruction_ref ins)
+{
+    // The dot must not have a c matrix, which would need a second accumulation
+    return ins->name() == "cpu::dot" and ins->inputs().size() == 3;
+}
+
+static bool is_fused_pointwise(instruction_ref ins)
+{
+    return ins->name() == "cpu::fused_pointwise";
+}
+
+MIGRAPHX_PRED_MATCHER(fusable_pointwise, instruction_ref ins)
+{
+    if(is_fused_pointwise(ins))
+        return true;
+    const auto& name = ins->name();
+    if(not starts_with(name, "cpu::"))
+        return false;
+    return get_pointwise_kernel(name.substr(5), ins->get_shape().type()).run != nullptr;
+}
+
+// Replaces an add of a bias to the output of a convolution or gemm, and the
+// relu that follows it when there is one
+template <class Op, class Fused, class FusedRelu, class M, class B>
+struct find_add_bias
+{
+    M gemm;
+    B bias;
+
+    template <class... Ms>
+    auto bias_add(Ms... ms) const
+    {
+        return match::name("cpu::add")(
+            match::either_arg(0, 1)(gemm(match::used_once()).bind("gemm"), bias.bind("bias")),
+            ms...);
+    }
+
+    auto matcher() const
+    {
+        return match::any_of(
+            match::name("cpu::relu")(match::arg(0)(bias_add(match::used_once())))
+                .bind("relu"),
+            bias_add(match::none_of(match::output(match::name("cpu::relu")))));
+    }
+
+    void apply(program& p, const match::matcher_result& r) const
+    {
+        auto gemm_ins = r.instructions.at("gemm");
+        auto bias_ins = skip_contiguous(r.instructions.at("bias"));
+        auto ins      = r.result;
+        auto op       = any_cast<Op>(gemm_ins->get_operator()).op;
+        auto args     = gemm_ins->inputs();
+        args.back()   = bias_ins;
+        args.push_back(ins->inputs().back());
+        if(contains(r.instructions, "relu"))
+            p.replace_instruction(ins, FusedRelu{op}, args);
+        else
+            p.replace_instruction(ins, Fused{op}, args);
+    }
+};
+
+template <class Op, class Fused, class FusedRelu, class M, class B>
+find_add_bias<Op, Fused, FusedRelu, M, B> make_find_add_bias(M gemm, B bias)
+{
+    return {gemm, bias};
+}
+
+// A chain of pointwise operators and the instructions they read
+struct pointwise_chain
+{
+    std::vector<std::string> ops;
+    std::vector<std::size_t> op_args;
+    std::vector<instruction_ref> inputs;
+
+    std::size_t index(instruction_ref ins) const
+    {
+        return std::distance(inputs.begin(), std::find(inputs.begin(), inputs.end(), ins));
+    }
+
+    void add_input(instruction_ref ins)
+    {
+        if(not contains(inputs, ins))
+            inputs.push_back(ins);
+    }
+};
+
+static pointwise_chain get_chain(instruction_ref ins)
+{
+    pointwise_chain result;
+    std::transform(ins->inputs().begin(),
+                   std::prev(ins->inputs().end()),
+                   std::back_inserter(result.inputs),
+                   &skip_contiguous);
+    if(is_fused_pointwise(ins))
+    {
+        const auto& op = any_cast<cpu_fused_pointwise>(ins->get_operator());
+        result.ops     = op.ops;
+        result.op_args = op.op_args;
+    }
+    else
+    {
+        result.ops = {ins->name().substr(5)};
+        result.op_args.resize(result.inputs.size());
+        std::iota(result.op_args.begin(), result.op_args.end(), 0);
+    }
+    return result;
+}
+
+// Computes the producer chain in front of the consumer chain, which reads
+// the result of the producer instead of its input instruction
+static pointwise_chain
+merge_chains(const pointwise_chain& consumer, instruction_ref ins, const pointwise_chain& producer)
+{
+    pointwise_chain result;
+    for(auto input : consumer.inputs)
+    {
+        if(input != ins)
+            result.add_input(input);
+    }
+    for(auto input : producer.inputs)
+        result.add_input(input);
+    const auto n = result.inputs.size();
+    result.ops   = producer.ops;
+    result.ops.insert(result.ops.end(), consumer.ops.begin(), consumer.ops.end());
+    for(auto a : producer.op_args)
+    {
+        if(a < producer.inputs.size())
+            result.op_args.push_back(result.index(producer.inputs[a]));
+        else
+            result.op_args.push_back(n + a - producer.inputs.size());
+    }
+    for(auto a : consumer.op_args)
+    {
+        if(a >= consumer.inputs.size())
+            result.op_args.push_back(n + producer.ops.size() + a - consumer.inputs.size());
+        else if(consumer.inputs[a] == ins)
+            result.op_args.push_back(n + producer.ops.size() - 1);
+        else
+            result.op_args.push_back(result.index(consumer.inputs[a]));
+    }
+    return result;
+}
+
+// Pointwise operators whose input is only used by them are merged with it,
+// so the intermediate result is never written to memory
+struct find_pointwise_chain
+{
+    auto matcher() const
+    {
+        return fusable_pointwise(match::any_of[match::inputs()](
+            match::any_of(fusable_pointwise(match::used_once()), broadcast_contiguous)));
+    }
+
+    void apply(program& p, const match::matcher_result& r) const
+    {
+        auto ins    = r.result;
+        auto chain  = get_chain(ins);
+        auto inputs = chain.inputs;
+        for(auto input : inputs)
+        {
+            // Skip the inputs that were already merged, when they are used twice
+            if(not contains(chain.inputs, input))
+                continue;
+            if(input->outputs().size() != 1 or not fusable_pointwise_m{}(input))
+                continue;
+            chain = merge_chains(chain, input, get_chain(input));
+        }
+        auto args = chain.inputs;
+        args.push_back(ins->inputs().back());
+        p.replace_instruction(ins, cpu_fused_pointwise{chain.ops, chain.op_args, {}}, args);
+    }
+};
+
+void fuse_ops::apply(program& p) const
+{
+    match::find_matches(
+        p,
+        make_find_add_bias<cpu_convolution<op::convolution>,
+                           cpu_conv_bias<false>,
+                           cpu_conv_bias<true>>(fusable_conv, bias_shape),
+        // The gemm accumulates into any bias, since it is copied to the output first
+        make_find_add_bias<cpu_gemm, cpu_dot_bias<false>, cpu_dot_bias<true>>(fusable_dot,
+                                                                              match::any));
+    match::find_matches(p, find_pointwise_chain{});
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
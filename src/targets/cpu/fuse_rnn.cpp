@@ -0,0 +1,104 @@
+#include <migraphx/cpu/fuse_rnn.hpp>
+#include <migraphx/cpu/rnn.hpp>
+#include <migraphx/cpu/allocate.hpp>
+#include <migraphx/rewrite_rnn.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/op/concat.hpp>
+#include <migraphx/op/identity.hpp>
+#include <migraphx/op/slice.hpp>
+#include <migraphx/op/squeeze.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// The hidden state of the last timestep of each direction, which is the
+// first timestep of the output for the reverse direction
+static instruction_ref
+last_output(program& p, instruction_ref pos, instruction_ref y, op::rnn_direction direction)
+{
+    auto seq_len = static_cast<int64_t>(y->get_shape().lens()[0]);
+    auto step    = [&](int64_t t, int64_t d) {
+        return p.insert_instruction(pos, op::slice{{0, 1}, {t, d}, {t + 1, d + 1}}, y);
+    };
+    if(direction == op::rnn_direction::bidirectional)
+        return p.insert_instruction(pos, op::concat{1}, step(seq_len - 1, 0), step(0, 1));
+    return step(direction == op::rnn_direction::forward ? seq_len - 1 : 0, 0);
+}
+
+template <class Op>
+static void fuse(program& p,
+                 instruction_ref ins,
+                 std::size_t gates,
+                 const std::vector<operation>& actv_funcs)
+{
+    if(ins->get_shape().type() != shape::float_type or
+       not all_of(actv_funcs, [](auto&& f) { return is_rnn_activation(f); }))
+        return;
+    auto op       = any_cast<Op>(ins->get_operator());
+    op.actv_funcs = actv_funcs;
+
+    auto args          = ins->inputs();
+    auto type          = ins->get_shape().type();
+    std::size_t dirs   = args[2]->get_shape().lens()[0];
+    std::size_t hidden = args[2]->get_shape().lens()[2];
+    std::size_t batch  = args[0]->get_shape().lens()[1];
+    // The kernels take every argument, so the ones that are not given are
+    // zero. The sequence lengths are ignored, as they are by rewrite_rnn.
+    auto arg = [&](std::size_t i, std::vector<std::size_t> lens) {
+        if(args.size() > i and args[i]->name() != "undefined")
+            return args[i];
+        shape s{type, std::move(lens)};
+        return p.add_literal(literal{s, std::vector<float>(s.elements(), 0)});
+    };
+    std::vector<instruction_ref> inputs = {args[0],
+                                           args[1],
+                                           args[2],
+                                           arg(3, {dirs, 2 * gates * hidden}),
+                                           arg(5, {dirs, batch, hidden})};
+    instruction_ref cell = p.end();
+    if(std::is_same<Op, op::lstm>{})
+    {
+        cell = p.insert_instruction(ins, cpu_allocate{shape{type, {dirs, batch, hidden}}});
+        inputs.push_back(arg(6, {dirs, batch, hidden}));
+        inputs.push_back(arg(7, {dirs, 3 * hidden}));
+        inputs.push_back(cell);
+    }
+    inputs.push_back(p.insert_instruction(ins, cpu_allocate{ins->get_shape()}));
+
+    auto outputs = ins->outputs();
+    p.replace_instruction(ins, cpu_rnn<Op>{op}, inputs);
+    for(auto output : outputs)
+    {
+        if(output->name() == "rnn_last_output")
+        {
+            auto last = last_output(p, output, ins, op.direction);
+            p.replace_instruction(output, op::squeeze{{0}}, last);
+        }
+        else if(output->name() == "lstm_last_cell_output")
+        {
+            // The cell state is read once the lstm has written it
+            p.replace_instruction(output, op::identity{}, cell, ins);
+        }
+    }
+}
+
+void fuse_rnn::apply(program& p) const
+{
+    for(auto ins : iterator_for(p))
+    {
+        if(ins->name() == "rnn")
+            fuse<op::rnn>(p, ins, 1, rewrite_rnn{}.vanilla_rnn_actv_funcs(ins));
+        else if(ins->name() == "gru")
+            fuse<op::gru>(p, ins, 3, rewrite_rnn{}.gru_actv_funcs(ins));
+        else if(ins->name() == "lstm")
+            fuse<op::lstm>(p, ins, 4, rewrite_rnn{}.lstm_actv_funcs(ins));
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
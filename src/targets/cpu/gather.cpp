@@ -0,0 +1,55 @@
+#include <migraphx/cpu/gather.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Bytes copied by one task
+constexpr std::size_t gather_grain = 64 * 1024;
+
+void gather(const argument& output,
+            const argument& data,
+            const argument& indices,
+            std::size_t axis)
+{
+    const auto& lens  = data.get_shape().lens();
+    std::size_t outer = std::accumulate(
+        lens.begin(), lens.begin() + axis, std::size_t{1}, std::multiplies<std::size_t>{});
+    std::size_t inner = std::accumulate(
+        lens.begin() + axis + 1, lens.end(), std::size_t{1}, std::multiplies<std::size_t>{});
+    auto n            = static_cast<std::int64_t>(lens[axis]);
+    std::size_t k     = indices.get_shape().elements();
+    std::size_t bytes = inner * data.get_shape().type_size();
+    std::size_t grain = std::max<std::size_t>(1, gather_grain / std::max<std::size_t>(1, bytes));
+    const char* in    = data.data();
+    char* out         = output.data();
+    indices.visit([&](auto idx) {
+        auto index = [&](std::size_t j) {
+            auto i = static_cast<std::int64_t>(idx[j]);
+            return i < 0 ? i + n : i;
+        };
+        for(std::size_t j = 0; j < k; j++)
+        {
+            auto i = index(j);
+            if(i < 0 or i >= n)
+                MIGRAPHX_THROW("gather: index " + std::to_string(i) + " is out of range");
+        }
+        par_for(outer * k, grain, [&](auto i) {
+            std::size_t o = i / k;
+            auto src      = (o * n + index(i % k)) * bytes;
+            std::memcpy(out + i * bytes, in + src, bytes);
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -2,7 +2,10 @@
 #include <migraphx/dfor.hpp>
 #include <migraphx/requires.hpp>
 #include <migraphx/shape_for_each.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/half.hpp>
 #include <blaze/math/CustomMatrix.h>
+#include <numeric>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -51,7 +54,11 @@ void migemm_impl(
     visit_mat(amat, [&](const auto& a) {
         visit_mat(bmat, [&](const auto& b) {
             auto c = make_mat(cmat);
-            c      = beta * c;
+            // As with BLAS, c is not read when beta is 0 so it can be uninitialized
+            if(beta == 0)
+                blaze::reset(c);
+            else
+                c = beta * c;
             // This is a simple optimization to avoid
             // compute A * B if alpha is 0.0
             if(alpha != 0.0)
@@ -62,46 +69,241 @@ void migemm_impl(
     });
 }
 
+// Element type used to accumulate the dot products
+template <class T>
+struct gemm_accumulator
+{
+    using type = T;
+};
+
+template <>
+struct gemm_accumulator<half>
+{
+    using type = float;
+};
+
+template <>
+struct gemm_accumulator<int8_t>
+{
+    using type = int32_t;
+};
+
+template <>
+struct gemm_accumulator<uint8_t>
+{
+    using type = int32_t;
+};
+
+// Layout of the matrices stored in the last two dimensions of a tensor
+struct matrix_layout
+{
+    std::size_t rows       = 0;
+    std::size_t cols       = 0;
+    std::size_t row_stride = 0;
+    std::size_t col_stride = 0;
+    // Leading dimensions, used to find where each matrix starts
+    shape batch{};
+
+    matrix_layout(const shape& s)
+    {
+        auto n_dims = s.lens().size();
+        rows        = s.lens()[n_dims - 2];
+        cols        = s.lens()[n_dims - 1];
+        row_stride  = s.strides()[n_dims - 2];
+        col_stride  = s.strides()[n_dims - 1];
+        if(n_dims > 2)
+            batch = shape{s.type(),
+                          {s.lens().begin(), s.lens().end() - 2},
+                          {s.strides().begin(), s.strides().end() - 2}};
+        else
+            batch = shape{s.type(), {1}, {0}};
+    }
+
+    std::size_t batches() const { return batch.elements(); }
+    std::size_t offset(std::size_t i) const { return batch.index(i); }
+};
+
+// Copy a tensor to a layout where the rows of each matrix are contiguous.
+// Batches that are broadcasted stay broadcasted.
+template <class T>
+static void pack_rows(tensor_view<T> dst, tensor_view<T> src)
+{
+    shape_for_each(src.get_shape(), [&](const auto& idx) {
+        dst(idx.begin(), idx.end()) = src(idx.begin(), idx.end());
+    });
+}
+
+static shape packed_shape(const shape& s)
+{
+    auto n_dims  = s.lens().size();
+    auto strides = s.strides();
+    strides[n_dims - 1] = 1;
+    strides[n_dims - 2] = s.lens()[n_dims - 1];
+    std::size_t stride  = s.lens()[n_dims - 1] * s.lens()[n_dims - 2];
+    for(std::size_t i = n_dims - 2; i > 0; i--)
+    {
+        if(s.strides()[i - 1] == 0)
+            continue;
+        strides[i - 1] = stride;
+        stride *= s.lens()[i - 1];
+    }
+    return {s.type(), s.lens(), strides};
+}
+
+argument pack_gemm_b(const argument& b_arg)
+{
+    argument result{packed_shape(b_arg.get_shape())};
+    visit_all(result, b_arg)([&](auto dst, auto src) { pack_rows(dst, src); });
+    return result;
+}
+
+bool is_gemm_b_packed(const shape& s) { return s.strides().back() == 1; }
+
+// Computes a tile of rows [i0, i1) and columns [j0, j1) of one matrix of c.
+// The rows of b must be contiguous, so the innermost loop runs over
+// contiguous memory of both b and the accumulators. Four products are summed
+// before they are added to an accumulator, which for int8 maps onto the
+// multiply-add dot-product instructions (pmaddwd, vpdpbusd) and cuts the
+// accumulator traffic by four.
+template <class T, class U, class Acc, class F>
+static void gemm_tile(T* c,
+                      const matrix_layout& cl,
+                      const U* a,
+                      const matrix_layout& al,
+                      const U* b,
+                      const matrix_layout& bl,
+                      F alpha,
+                      F beta,
+                      std::size_t i0,
+                      std::size_t i1,
+                      std::size_t j0,
+                      std::size_t j1,
+                      Acc* acc)
+{
+    const auto nj = j1 - j0;
+    const auto k  = al.cols;
+    for(std::size_t i = i0; i < i1; i++)
+    {
+        std::fill(acc, acc + nj, Acc{0});
+        const U* a_row = a + i * al.row_stride;
+        std::size_t kk = 0;
+        for(; kk + 4 <= k; kk += 4)
+        {
+            const auto a0   = static_cast<Acc>(a_row[kk * al.col_stride]);
+            const auto a1   = static_cast<Acc>(a_row[(kk + 1) * al.col_stride]);
+            const auto a2   = static_cast<Acc>(a_row[(kk + 2) * al.col_stride]);
+            const auto a3   = static_cast<Acc>(a_row[(kk + 3) * al.col_stride]);
+            const U* b_row0 = b + kk * bl.row_stride + j0;
+            const U* b_row1 = b_row0 + bl.row_stride;
+            const U* b_row2 = b_row1 + bl.row_stride;
+            const U* b_row3 = b_row2 + bl.row_stride;
+            for(std::size_t j = 0; j < nj; j++)
+            {
+                acc[j] += a0 * static_cast<Acc>(b_row0[j]) + a1 * static_cast<Acc>(b_row1[j]) +
+                          a2 * static_cast<Acc>(b_row2[j]) + a3 * static_cast<Acc>(b_row3[j]);
+            }
+        }
+        for(; kk < k; kk++)
+        {
+            const auto av  = static_cast<Acc>(a_row[kk * al.col_stride]);
+            const U* b_row = b + kk * bl.row_stride + j0;
+            for(std::size_t j = 0; j < nj; j++)
+                acc[j] += av * static_cast<Acc>(b_row[j]);
+        }
+        T* c_row = c + i * cl.row_stride;
+        for(std::size_t j = 0; j < nj; j++)
+        {
+            auto& cv = c_row[(j0 + j) * cl.col_stride];
+            if(beta == 0)
+                cv = static_cast<T>(alpha * acc[j]);
+            else
+                cv = static_cast<T>(alpha * acc[j] + beta * static_cast<Acc>(cv));
+        }
+    }
+}
+
+// Batched gemm, parallelized over batches and tiles of c
+template <class T, class U, class F>
+static void gemm_batched(tensor_view<T> cmat, tensor_view<U> amat, tensor_view<U> bmat, F alpha, F beta)
+{
+    using acc_type                  = typename gemm_accumulator<U>::type;
+    const std::size_t row_tile      = 16;
+    const std::size_t col_tile      = 256;
+    std::vector<U> packed;
+    const U* b = bmat.data();
+    shape b_shape = bmat.get_shape();
+    if(not is_gemm_b_packed(b_shape))
+    {
+        b_shape = packed_shape(b_shape);
+        packed.resize(b_shape.bytes() / sizeof(U));
+        pack_rows(tensor_view<U>{b_shape, packed.data()}, bmat);
+        b = packed.data();
+    }
+
+    matrix_layout cl{cmat.get_shape()};
+    matrix_layout al{amat.get_shape()};
+    matrix_layout bl{b_shape};
+    const auto row_tiles = (cl.rows + row_tile - 1) / row_tile;
+    const auto col_tiles = (cl.cols + col_tile - 1) / col_tile;
+    const auto ntiles    = row_tiles * col_tiles;
+
+    std::vector<std::vector<acc_type>> buffers(get_thread_pool().size(),
+                                               std::vector<acc_type>(col_tile));
+    par_for(cl.batches() * ntiles, 1, [&](std::size_t idx, std::size_t tid) {
+        const auto batch = idx / ntiles;
+        const auto tile  = idx % ntiles;
+        const auto i0    = (tile / col_tiles) * row_tile;
+        const auto j0    = (tile % col_tiles) * col_tile;
+        gemm_tile(cmat.data() + cl.offset(batch),
+                  cl,
+                  amat.data() + al.offset(batch),
+                  al,
+                  b + bl.offset(batch),
+                  bl,
+                  alpha,
+                  beta,
+                  i0,
+                  std::min(i0 + row_tile, cl.rows),
+                  j0,
+                  std::min(j0 + col_tile, cl.cols),
+                  buffers[tid].data());
+    });
+}
+
+// Blaze is used for single float matrices that it can describe directly
+template <class T>
+static bool use_blaze(tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat)
+{
+    if(not is_fast_gemm_type<T>{})
+        return false;
+    auto is_matrix = [](const shape& s) {
+        auto n_dims = s.lens().size();
+        auto batch  = std::accumulate(s.lens().begin(),
+                                     s.lens().end() - 2,
+                                     std::size_t{1},
+                                     std::multiplies<std::size_t>());
+        auto unit   = s.transposed() ? s.strides()[n_dims - 2] : s.strides()[n_dims - 1];
+        return batch == 1 and unit == 1;
+    };
+    return is_matrix(cmat.get_shape()) and not cmat.get_shape().transposed() and
+           is_matrix(amat.get_shape()) and is_matrix(bmat.get_shape());
+}
+
 template <class T, class F>
 void migemm_impl(
     tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta, std::false_type)
 {
-    std::size_t n_dims = cmat.get_shape().lens().size();
-    std::size_t dim_0  = n_dims - 2;
-    std::size_t dim_1  = n_dims - 1;
-    auto k             = amat.get_shape().lens()[dim_1];
-
-    assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-
-    shape_for_each(cmat.get_shape(), [&](const auto& c_idx) {
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += amat(a_idx.begin(), a_idx.end()) * bmat(b_idx.begin(), b_idx.end());
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
-    });
+    gemm_batched(cmat, amat, bmat, alpha, beta);
 }
 
 template <class T, class F>
 void migemm_impl(tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta)
 {
-    auto lens = amat.get_shape().lens();
-    bool batch_mul =
-        std::accumulate(
-            lens.rbegin() + 2, lens.rend(), std::size_t{1}, std::multiplies<std::size_t>()) == 1;
-    if(batch_mul)
-    {
+    assert(amat.get_shape().lens().back() == bmat.get_shape().lens().rbegin()[1]);
+    if(use_blaze(cmat, amat, bmat))
         migemm_impl(cmat, amat, bmat, alpha, beta, is_fast_gemm_type<T>{});
-    }
     else
-    {
         migemm_impl(cmat, amat, bmat, alpha, beta, std::false_type{});
-    }
 }
 
 template <class F>
@@ -124,6 +326,14 @@ void migemm(const argument& c_arg,
             int32_t alpha,
             int32_t beta)
 {
+    // int8 inputs are multiplied as is and accumulated into the int32 output
+    if(a_arg.get_shape().type() == shape::int8_type and
+       c_arg.get_shape().type() == shape::int32_type)
+    {
+        gemm_batched(
+            c_arg.get<int32_t>(), a_arg.get<int8_t>(), b_arg.get<int8_t>(), alpha, beta);
+        return;
+    }
     migemm_tpl(c_arg, a_arg, b_arg, alpha, beta);
 }
 
@@ -0,0 +1,96 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_ALLOCATE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_ALLOCATE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <cstring>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// Allocate an uninitialized buffer whose data is aligned to alignment bytes
+argument allocate_aligned(const shape& s, std::size_t alignment = 64);
+
+struct cpu_allocate
+{
+    shape s;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.s, "shape"));
+    }
+
+    std::string name() const { return "cpu::allocate"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs}.has(0);
+        return s;
+    }
+    argument compute(context&, const shape& output_shape, const std::vector<argument>&) const
+    {
+        return argument{output_shape};
+    }
+};
+
+struct cpu_load_memory
+{
+    shape s;
+    std::string id{};
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.s, "shape"), f(self.id, "id"));
+    }
+
+    std::string name() const { return "cpu::load_memory"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs}.has(0);
+        return s;
+    }
+    // The memory is allocated when the program is finalized, so it is also
+    // available for a program that was loaded instead of compiled
+    void finalize(context& ctx, const shape&, const std::vector<shape>&)
+    {
+        if(ctx.preallocations.count(id) == 0)
+            ctx.preallocations[id] = allocate_aligned(s);
+    }
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        return ctx.get_preallocation(id);
+    }
+};
+
+// Copies a program output out of the preallocated memory, so the result stays
+// valid after the next eval reuses the memory
+struct cpu_copy
+{
+    std::string name() const { return "cpu::copy"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs}.has(1);
+        return inputs.at(0);
+    }
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        // Wait for the operators that are still running on other lanes
+        ctx.finish();
+        argument result{output_shape};
+        std::memcpy(result.data(), args[0].data(), output_shape.bytes());
+        return result;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_CONCAT_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_CONCAT_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/op/concat.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/config.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * Copy the inputs into output one after another along axis. Each input is a
+ * slab of the output for every index of the dimensions before the axis, and
+ * the slabs of all the inputs are copied in parallel, with memcpy when the
+ * input is standard.
+ */
+void concat(const argument& output, const std::vector<argument>& inputs, std::size_t axis);
+
+struct cpu_concat
+{
+    op::concat op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "cpu::concat"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    argument compute(context&, const shape&, std::vector<argument> args) const;
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
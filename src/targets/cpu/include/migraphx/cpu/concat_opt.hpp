@@ -0,0 +1,24 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_CONCAT_OPT_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_CONCAT_OPT_HPP
+
+#include <migraphx/cpu/concat.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct concat_cpu_optimization
+{
+    std::string name() const { return "cpu::concat"; }
+    std::string allocate() const { return "cpu::allocate"; }
+    migraphx::op::concat get_concat(const migraphx::operation& op) const
+    {
+        return migraphx::any_cast<cpu_concat>(op).op;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
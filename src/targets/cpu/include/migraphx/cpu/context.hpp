@@ -1,7 +1,13 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
+#include <migraphx/argument.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/cpu/lane.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -9,7 +15,34 @@ namespace cpu {
 
 struct context
 {
-    void finish() const {}
+    void finish() const
+    {
+        for(auto&& l : lanes)
+            l->finish();
+    }
+
+    argument get_preallocation(const std::string& id) const { return preallocations.at(id); }
+
+    /// Lane 0 is the thread that evaluates the program, so it has no lane
+    lane* get_lane(std::size_t n) const { return n == 0 ? nullptr : lanes.at(n - 1).get(); }
+
+    lane_event& get_event(std::size_t n) { return events.at(n); }
+
+    void create_lanes(std::size_t n)
+    {
+        while(lanes.size() + 1 < n)
+            lanes.push_back(std::make_shared<lane>());
+    }
+
+    void create_events(std::size_t n)
+    {
+        if(events.size() < n)
+            events.resize(n);
+    }
+
+    std::unordered_map<std::string, argument> preallocations{};
+    std::vector<std::shared_ptr<lane>> lanes{};
+    std::vector<lane_event> events{};
 };
 
 } // namespace cpu
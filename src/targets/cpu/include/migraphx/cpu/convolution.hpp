@@ -0,0 +1,120 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_CONVOLUTION_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_CONVOLUTION_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+enum class conv_algorithm
+{
+    // Reference loop, used for non-standard layouts
+    naive,
+    // Register-blocked direct convolution
+    direct,
+    // 1x1, unit stride, unpadded convolution computed as one gemm per image and group
+    gemm,
+    // im2col followed by gemm
+    im2col,
+    // Direct convolution that reads and writes channels last (NHWC) tensors,
+    // with the output channels in the innermost loop
+    nhwc
+};
+
+std::string to_string(conv_algorithm algo);
+
+struct conv_params
+{
+    std::array<std::size_t, 2> padding  = {{0, 0}};
+    std::array<std::size_t, 2> stride   = {{1, 1}};
+    std::array<std::size_t, 2> dilation = {{1, 1}};
+    std::size_t group                   = 1;
+
+    template <class Op>
+    static conv_params from(const Op& op)
+    {
+        return {op.padding, op.stride, op.dilation, static_cast<std::size_t>(op.group)};
+    }
+};
+
+/// Work applied to the output of a convolution while it is still in the cache
+struct conv_epilogue
+{
+    /// Added to every output channel when it is not empty. It has the lens of
+    /// the output, and is broadcasted on every dimension except the channels.
+    argument bias{};
+    /// Clamp the output to zero after adding the bias
+    bool relu = false;
+};
+
+/// Whether s is a 4d NCHW tensor whose elements are stored in NHWC order
+bool is_channels_last(const shape& s);
+
+/// The shape with the lens of s and the elements stored in NHWC order
+shape make_channels_last(const shape& s);
+
+/// The output shape of a convolution computed into an allocation, which
+/// keeps the layout of the allocation when it is channels last
+shape conv_output_shape(const shape& output, const shape& allocation);
+
+/// Pick the fastest algorithm for the given shapes
+conv_algorithm select_conv_algorithm(const conv_params& params,
+                                     const shape& output,
+                                     const shape& input,
+                                     const shape& weights);
+
+/// Compute a 2d convolution into result, where the tensors have NCHW lens
+void conv2d(const conv_params& params,
+            conv_algorithm algo,
+            const argument& result,
+            const argument& input,
+            const argument& weights,
+            const conv_epilogue& epilogue = {});
+
+template <class Op>
+struct cpu_convolution
+{
+    Op op;
+    conv_algorithm algo = conv_algorithm::naive;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        auto allocation = inputs.back();
+        inputs.pop_back();
+        return conv_output_shape(op.compute_shape(inputs), allocation);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    void finalize(context&, const shape& output_shape, const std::vector<shape>& inputs)
+    {
+        algo = select_conv_algorithm(conv_params::from(op), output_shape, inputs[0], inputs[1]);
+    }
+    argument compute(context&, const shape&, std::vector<argument> args) const
+    {
+        argument result = args.back();
+        conv2d(conv_params::from(op), algo, result, args[0], args[1]);
+        return result;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
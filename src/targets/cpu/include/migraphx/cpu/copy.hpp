@@ -0,0 +1,27 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_COPY_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_COPY_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * Copy input into output, which have the same lens and type but can have any
+ * strides, such as a transposed, sliced or broadcasted input. Dimensions of 1
+ * are removed and adjacent dimensions that are contiguous in both tensors
+ * are merged first. Runs that are contiguous in both are copied with memcpy.
+ * When the innermost dimension of the output is another one than the
+ * innermost of the input, they are copied in square tiles so both the reads
+ * and the writes stay in the cache. The work is split between the threads of
+ * the thread pool.
+ */
+void strided_copy(const argument& output, const argument& input);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
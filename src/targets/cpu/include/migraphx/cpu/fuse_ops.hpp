@@ -0,0 +1,26 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_FUSE_OPS_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_FUSE_OPS_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * Fuses lowered cpu operators so intermediate results are not written to
+ * memory: a bias and relu are applied by convolutions and gemms to their
+ * output, and chains of pointwise operators are computed in one loop.
+ */
+struct fuse_ops
+{
+    std::string name() const { return "cpu::fuse_ops"; }
+    void apply(program& p) const;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
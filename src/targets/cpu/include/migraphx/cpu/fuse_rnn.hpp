@@ -0,0 +1,30 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_FUSE_RNN_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_FUSE_RNN_HPP
+
+#include <string>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+struct program;
+
+namespace cpu {
+
+/**
+ * Replaces the float rnn, gru and lstm operators with cpu kernels that
+ * compute the whole sequence, instead of the graph of gemms and pointwise
+ * operators for every timestep that rewrite_rnn unrolls them into. It runs
+ * before rewrite_rnn, which still rewrites the operators whose activation
+ * functions the kernels do not support.
+ */
+struct fuse_rnn
+{
+    std::string name() const { return "cpu::fuse_rnn"; }
+    void apply(program& p) const;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_GATHER_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_GATHER_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * Compute the gather operator along axis into output, where data, indices and
+ * output are standard. Every index selects a contiguous slab of the
+ * dimensions after the axis, which is copied with memcpy, and the slabs are
+ * copied in parallel. The indices are read with their own integer type and
+ * are checked to be in range before anything is copied.
+ */
+void gather(const argument& output,
+            const argument& data,
+            const argument& indices,
+            std::size_t axis);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -3,6 +3,11 @@
 
 #include <migraphx/argument.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/op/dot.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -16,6 +21,69 @@ void migemm(const argument& c_arg,
             int32_t alpha,
             int32_t beta);
 
+/// Whether the rows of the matrices in b are already contiguous
+bool is_gemm_b_packed(const shape& s);
+
+/// Copy the b matrix of a gemm so its rows are contiguous, which avoids packing it on every call
+argument pack_gemm_b(const argument& b_arg);
+
+struct cpu_gemm
+{
+    op::dot op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::dot"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        if(inputs.size() == 3)
+        {
+            auto c_shape = inputs.at(2);
+            check_shapes{{c_shape}}.not_broadcasted();
+        }
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+
+    argument compute(context&, const shape&, std::vector<argument> args) const
+    {
+        argument result = args.back();
+        args.pop_back();
+        // 3 inputs, it is alpha * A * B + beta * C, then
+        // A and B are matrices, and C is of the same shape as A * B
+        if(args.size() == 3)
+        {
+            // no need to consider the value of args[2]
+            if(op.beta == 0.0f)
+            {
+                result.visit([&](auto output) { std::fill(output.begin(), output.end(), 0); });
+            }
+            else
+            {
+                visit_all(result, args[2])([&](auto output, auto input) {
+                    std::copy(input.begin(), input.end(), output.begin());
+                });
+            }
+
+            migemm(result, args[0], args[1], op.alpha, op.beta);
+
+            return result;
+        }
+
+        // 2 input arguments
+        migemm(result, args[0], args[1], op.alpha, 0.0f);
+
+        return result;
+    }
+};
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
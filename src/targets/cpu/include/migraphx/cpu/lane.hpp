@@ -0,0 +1,68 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_LANE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_LANE_HPP
+
+#include <migraphx/config.hpp>
+#include <functional>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct context;
+
+namespace cpu {
+
+struct lane_impl;
+struct lane_event_state;
+
+/**
+ * @brief A thread that runs tasks in the order they are submitted
+ *
+ * A lane plays the role of a stream on the gpu: operators scheduled on
+ * different lanes run concurrently, and their kernels still split their work
+ * over the shared thread pool.
+ */
+struct lane
+{
+    using task = std::function<void(migraphx::context&)>;
+
+    lane();
+
+    lane(const lane&) = delete;
+    lane& operator=(const lane&) = delete;
+
+    /// Waits for the submitted tasks before stopping the thread
+    ~lane() noexcept;
+
+    /// Run f on the lane after the tasks submitted before it. The context
+    /// passed to f belongs to the lane.
+    void submit(task f);
+
+    /// Wait for every submitted task, and rethrow the first exception thrown
+    /// by one of them
+    void finish();
+
+    private:
+    std::unique_ptr<lane_impl> impl;
+};
+
+/// A point in a lane that other lanes can wait for, like an event on a gpu
+/// stream. A null lane stands for the thread that evaluates the program.
+struct lane_event
+{
+    lane_event();
+
+    /// Signal the event once the tasks already submitted to l are done
+    void record(lane* l);
+    /// Make l wait until the last record submitted so far is signaled
+    void wait(lane* l);
+
+    private:
+    std::shared_ptr<lane_event_state> state;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_LAYOUT_NHWC_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_LAYOUT_NHWC_HPP
+
+#include <string>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+struct program;
+
+namespace cpu {
+
+/**
+ * Keeps tensors that are stored channels last (NHWC), such as the ones of a
+ * model imported from tensorflow, in that layout around the lowered
+ * convolutions. A convolution reads a channels last input directly instead of
+ * through a contiguous copy, and writes its output channels last when that
+ * makes a contiguous copy of a transpose of it unnecessary. Contiguous copies
+ * are then only left where a channels last tensor meets an operator that
+ * needs a standard one.
+ */
+struct layout_nhwc
+{
+    std::string name() const { return "cpu::layout_nhwc"; }
+    void apply(program& p) const;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_POINTWISE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_POINTWISE_HPP
+
+#include <migraphx/shape.hpp>
+#include <migraphx/tensor_view.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/operators.hpp>
+#include <migraphx/config.hpp>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * The dimensions of tensors with the same lens, where adjacent dimensions are
+ * merged when every tensor is contiguous across them and dimensions of 1 are
+ * removed. A broadcasted tensor has a stride of 0 and a transposed one keeps
+ * its strides, so they are still iterated with strides instead of indices.
+ */
+struct pointwise_dims
+{
+    std::vector<std::size_t> lens;
+    // The strides of each tensor, in the order of the shapes
+    std::vector<std::vector<std::size_t>> strides;
+};
+
+pointwise_dims collapse_dims(const std::vector<shape>& shapes);
+
+/// Split the elements of tensors with the same lens into blocks along the
+/// innermost collapsed dimension, and call f on each block on the thread pool.
+/// f is called with the id of the thread, the number of elements in the
+/// block, and the offset and stride of the block in each tensor, in elements.
+using pointwise_block_fn = std::function<void(
+    std::size_t tid, std::size_t n, const std::size_t* offsets, const std::size_t* strides)>;
+
+void pointwise_blocks(const std::vector<shape>& shapes, const pointwise_block_fn& f);
+
+/// Elements in one block, so the block of every tensor fits in the L1 cache
+constexpr std::size_t pointwise_block_size = 4096;
+
+/// The unary and binary operators computed by pointwise kernels. They have no
+/// attributes and produce the type of their inputs, so they can be fused.
+template <class... Ops>
+struct pointwise_op_list
+{
+};
+
+using pointwise_ops = pointwise_op_list<op::abs,
+                                        op::acos,
+                                        op::acosh,
+                                        op::add,
+                                        op::asin,
+                                        op::asinh,
+                                        op::atan,
+                                        op::atanh,
+                                        op::ceil,
+                                        op::cos,
+                                        op::cosh,
+                                        op::div,
+                                        op::erf,
+                                        op::exp,
+                                        op::floor,
+                                        op::log,
+                                        op::max,
+                                        op::min,
+                                        op::mul,
+                                        op::neg,
+                                        op::pow,
+                                        op::prelu,
+                                        op::recip,
+                                        op::relu,
+                                        op::round,
+                                        op::rsqrt,
+                                        op::sigmoid,
+                                        op::sign,
+                                        op::sin,
+                                        op::sinh,
+                                        op::sqdiff,
+                                        op::sqrt,
+                                        op::sub,
+                                        op::tan,
+                                        op::tanh>;
+
+/// A pointwise operator computed over n elements of one type
+struct pointwise_kernel
+{
+    /// data[0] is the output and the rest are the inputs, which are stepped by
+    /// the strides, in elements
+    using function = void (*)(std::size_t n, char* const* data, const std::size_t* strides);
+    function run       = nullptr;
+    std::size_t inputs = 0;
+};
+
+/// The kernel of the operator in pointwise_ops with the name, for the type.
+/// Its function is null when there is none.
+pointwise_kernel get_pointwise_kernel(const std::string& name, shape::type_t t);
+
+namespace detail {
+
+template <class F, class T, class... Ts>
+void pointwise_contiguous(F f, std::size_t n, T* out, const Ts*... ins)
+{
+    for(std::size_t i = 0; i < n; i++)
+        out[i] = f(ins[i]...);
+}
+
+template <class F, class T, class... Ts>
+void pointwise_strided(F f, std::size_t n, const std::size_t* strides, T* out, const Ts*... ins)
+{
+    sequence_c<sizeof...(Ts)>([&](auto... is) {
+        for(std::size_t i = 0; i < n; i++)
+            out[i * strides[0]] = f(ins[i * strides[is + 1]]...);
+    });
+}
+
+} // namespace detail
+
+/// Compute output = f(inputs...) element by element. The blocks are computed
+/// in parallel, and when every tensor is contiguous in a block it is a plain
+/// loop over pointers that the compiler can vectorize.
+template <class F, class T, class... Ts>
+void pointwise(F f, tensor_view<T> output, tensor_view<Ts>... inputs)
+{
+    pointwise_blocks(
+        {output.get_shape(), inputs.get_shape()...},
+        [&](std::size_t, std::size_t n, const std::size_t* offsets, const std::size_t* strides) {
+            bool contiguous =
+                std::all_of(strides, strides + sizeof...(Ts) + 1, [](auto s) { return s == 1; });
+            sequence_c<sizeof...(Ts)>([&](auto... is) {
+                auto* out = output.data() + offsets[0];
+                if(contiguous)
+                    detail::pointwise_contiguous(f, n, out, (inputs.data() + offsets[is + 1])...);
+                else
+                    detail::pointwise_strided(
+                        f, n, strides, out, (inputs.data() + offsets[is + 1])...);
+            });
+        });
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
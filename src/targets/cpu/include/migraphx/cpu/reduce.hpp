@@ -0,0 +1,57 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_REDUCE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_REDUCE_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/shape.hpp>
+#include <migraphx/config.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct reduce_dim
+{
+    std::size_t len        = 1;
+    std::size_t in_stride  = 0;
+    std::size_t out_stride = 0;
+};
+
+/**
+ * The dimensions of a reduction, where dimensions of 1 are removed and
+ * adjacent dimensions that are both reduced or both kept are merged when the
+ * input, and the output for kept ones, steps over them contiguously. A
+ * reduction over every axis of a standard tensor has a single reduced
+ * dimension.
+ */
+struct reduce_dims
+{
+    /// The dimensions of the output, outermost first
+    std::vector<reduce_dim> kept;
+    /// The dimensions that are reduced, outermost first. There is always at
+    /// least one.
+    std::vector<reduce_dim> reduced;
+    /// Whether the innermost dimension of the input is reduced
+    bool inner_reduced = true;
+};
+
+reduce_dims collapse_reduce_dims(const shape& input, const shape& output);
+
+/**
+ * Compute the reduce_sum, reduce_mean, reduce_max, reduce_min or reduce_prod
+ * operator with the name, where the reduced axes are the ones of length 1 in
+ * output. When the innermost dimension is reduced, each output reduces
+ * contiguous runs of the input. Otherwise a block of outputs next to each
+ * other is accumulated one row of the input at a time. The outputs are
+ * computed in parallel, and when there are fewer outputs than threads the
+ * rows of the reduction are split between the threads instead. Floating
+ * point sums are pairwise over contiguous runs and compensated across them.
+ */
+void reduce(const std::string& name, const argument& output, const argument& input);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
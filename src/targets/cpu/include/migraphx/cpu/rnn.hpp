@@ -0,0 +1,79 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_RNN_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_RNN_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/op/rnn.hpp>
+#include <migraphx/op/gru.hpp>
+#include <migraphx/op/lstm.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/config.hpp>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// Whether the fused rnn kernels can apply the activation function
+bool is_rnn_activation(const operation& op);
+
+/**
+ * The hidden states of a whole sequence for the rnn, gru or lstm operator,
+ * whose activation functions are listed for every direction. The args are
+ * the input, the weights, the recurrence weights, the bias and the initial
+ * hidden state, followed by the initial cell state, the peepholes and the
+ * output for the last cell state of an lstm. They are all given and in the
+ * standard layout, and only float is supported.
+ *
+ * The input of every timestep is multiplied by the weights in one gemm up
+ * front, so each step only multiplies the previous hidden state by the
+ * recurrence weights, whose transpose is packed once. The gates are then
+ * computed in one loop that writes the hidden state straight into output.
+ * The directions of a bidirectional operator run in parallel.
+ */
+void rnn_sequence(const op::rnn& op, const argument& output, const std::vector<argument>& args);
+void rnn_sequence(const op::gru& op, const argument& output, const std::vector<argument>& args);
+void rnn_sequence(const op::lstm& op, const argument& output, const std::vector<argument>& args);
+
+template <class Op>
+struct cpu_rnn
+{
+    Op op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    // The lstm also has an allocation for the last cell state before the
+    // one for the output
+    static std::size_t allocations() { return std::is_same<Op, op::lstm>{} ? 2 : 1; }
+
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.resize(inputs.size() - allocations());
+        return op.compute_shape(inputs);
+    }
+    argument compute(context&, const shape&, std::vector<argument> args) const
+    {
+        argument result = args.back();
+        args.pop_back();
+        rnn_sequence(op, result, args);
+        return result;
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_CPU_SOFTMAX_HPP
+#define MIGRAPHX_GUARD_RTGLIB_CPU_SOFTMAX_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/**
+ * Compute the softmax of input along axis into output, or the logsoftmax when
+ * log is true. The rows along an innermost contiguous axis are computed with
+ * plain loops over pointers. For other axes of standard tensors a block of
+ * rows is computed together, so the elements that are read at once are next
+ * to each other. The max, then the exponentials and their sum, and then the
+ * normalization each take one pass over a row.
+ *
+ * For float, the exponentials use a polynomial that the compiler can
+ * vectorize, with an error of a few ulp. Setting MIGRAPHX_CPU_ACCURATE_EXP
+ * uses std::exp instead.
+ */
+void softmax(const argument& output, const argument& input, std::size_t axis, bool log);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
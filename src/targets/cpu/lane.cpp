@@ -0,0 +1,148 @@
+#include <migraphx/cpu/lane.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/context.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct lane_impl
+{
+    std::mutex m;
+    std::condition_variable ready;
+    std::condition_variable idle;
+    std::deque<lane::task> tasks;
+    bool busy                    = false;
+    bool stop                    = false;
+    std::exception_ptr error     = nullptr;
+    migraphx::context ctx        = context{};
+    // Started last, once the other members are initialized
+    std::thread worker{[this] { this->run(); }};
+
+    void run()
+    {
+        for(;;)
+        {
+            lane::task t;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                ready.wait(lock, [&] { return stop or not tasks.empty(); });
+                if(tasks.empty())
+                    return;
+                t = std::move(tasks.front());
+                tasks.pop_front();
+                busy = true;
+            }
+            // Later tasks still run after an exception, so the events they
+            // record do not leave the other lanes waiting
+            try
+            {
+                t(ctx);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if(error == nullptr)
+                    error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(m);
+            busy = false;
+            if(tasks.empty())
+                idle.notify_all();
+        }
+    }
+};
+
+lane::lane() : impl(std::make_unique<lane_impl>()) {}
+
+lane::~lane() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        impl->stop = true;
+    }
+    impl->ready.notify_one();
+    impl->worker.join();
+}
+
+void lane::submit(task f)
+{
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        impl->tasks.push_back(std::move(f));
+    }
+    impl->ready.notify_one();
+}
+
+void lane::finish()
+{
+    std::unique_lock<std::mutex> lock(impl->m);
+    impl->idle.wait(lock, [&] { return impl->tasks.empty() and not impl->busy; });
+    if(impl->error != nullptr)
+    {
+        auto e      = impl->error;
+        impl->error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+struct lane_event_state
+{
+    std::mutex m;
+    std::condition_variable cv;
+    std::size_t recorded = 0;
+    std::size_t signaled = 0;
+
+    void signal(std::size_t n)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            signaled = std::max(signaled, n);
+        }
+        cv.notify_all();
+    }
+
+    void wait_for(std::size_t n)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return signaled >= n; });
+    }
+};
+
+lane_event::lane_event() : state(std::make_shared<lane_event_state>()) {}
+
+void lane_event::record(lane* l)
+{
+    std::size_t n = 0;
+    {
+        std::lock_guard<std::mutex> lock(state->m);
+        n = ++state->recorded;
+    }
+    if(l == nullptr)
+        state->signal(n);
+    else
+        l->submit([s = state, n](migraphx::context&) { s->signal(n); });
+}
+
+void lane_event::wait(lane* l)
+{
+    std::size_t n = 0;
+    {
+        std::lock_guard<std::mutex> lock(state->m);
+        n = state->recorded;
+    }
+    if(l == nullptr)
+        state->wait_for(n);
+    else
+        l->submit([s = state, n](migraphx::context&) { s->wait_for(n); });
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,126 @@
+#include <migraphx/cpu/layout_nhwc.hpp>
+#include <migraphx/cpu/allocate.hpp>
+#include <migraphx/cpu/convolution.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+static bool is_conv(instruction_ref ins)
+{
+    return contains({"cpu::convolution",
+                     "cpu::quant_convolution",
+                     "cpu::conv_bias",
+                     "cpu::conv_bias_relu"},
+                    ins->name());
+}
+
+// A copy inserted by auto_contiguous
+static bool is_contiguous(instruction_ref ins) { return ins->name() == "cpu::contiguous"; }
+
+// The outputs of the program are copied by cpu::copy, which keeps the layout
+// of its input
+static bool is_output(instruction_ref ins, const program& p)
+{
+    return ins == std::prev(p.end()) or
+           std::any_of(ins->outputs().begin(), ins->outputs().end(), [](auto out) {
+               return out->name() == "@return" or out->name() == "cpu::copy";
+           });
+}
+
+// Operators that read their first input with any layout
+static bool reads_any_layout(instruction_ref ins, instruction_ref input)
+{
+    if(not is_conv(ins) and not starts_with(ins->name(), "cpu::pooling_"))
+        return false;
+    const auto& inputs = ins->inputs();
+    return inputs.front() == input and std::count(inputs.begin(), inputs.end(), input) == 1;
+}
+
+// Whether the result of ins can have the shape s instead, where the only
+// operators whose shape changes with it are transposes. The contiguous
+// copies that become unnecessary are added to copies.
+static bool can_change_layout(instruction_ref ins,
+                              const shape& s,
+                              const program& p,
+                              std::vector<instruction_ref>& copies)
+{
+    for(auto out : ins->outputs())
+    {
+        if(reads_any_layout(out, ins))
+            continue;
+        if(is_contiguous(out))
+        {
+            // The copy of a program output is not in the memory that is reused
+            if(s.standard() and not is_output(out, p))
+                copies.push_back(out);
+            continue;
+        }
+        if(out->name() != "cpu::transpose")
+            return false;
+        if(not can_change_layout(out, out->get_operator().compute_shape({s}), p, copies))
+            return false;
+    }
+    return true;
+}
+
+// Convolutions read a channels last input without the copy
+static void remove_input_copies(program& p)
+{
+    for(auto ins : iterator_for(p))
+    {
+        if(not is_contiguous(ins) or ins->outputs().empty() or is_output(ins, p))
+            continue;
+        auto input = ins->inputs().front();
+        if(not is_channels_last(input->get_shape()))
+            continue;
+        if(std::all_of(ins->outputs().begin(), ins->outputs().end(), [&](auto out) {
+               return reads_any_layout(out, ins);
+           }))
+            p.replace_instruction(ins, input);
+    }
+}
+
+// Convolutions whose output is transposed to NHWC and then copied write it
+// channels last instead, so the transpose is already standard
+static void write_channels_last(program& p)
+{
+    for(auto ins : iterator_for(p))
+    {
+        if(not is_conv(ins) or ins->get_shape().lens().size() != 4 or
+           not ins->get_shape().standard())
+            continue;
+        auto alloc = ins->inputs().back();
+        if(alloc->name() != "cpu::allocate" or alloc->outputs().size() != 1)
+            continue;
+        auto s = make_channels_last(ins->get_shape());
+        std::vector<instruction_ref> copies;
+        if(not can_change_layout(ins, s, p, copies) or copies.empty())
+            continue;
+        auto new_alloc = p.insert_instruction(alloc, cpu_allocate{s});
+        instruction::replace_argument(ins, alloc, new_alloc);
+        assert(ins->get_shape() == s);
+        for(auto copy : copies)
+        {
+            assert(copy->inputs().front()->get_shape().standard());
+            p.replace_instruction(copy, copy->inputs().front());
+        }
+    }
+}
+
+void layout_nhwc::apply(program& p) const
+{
+    remove_input_copies(p);
+    write_channels_last(p);
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
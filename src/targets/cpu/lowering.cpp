@@ -18,10 +18,21 @@
 #include <migraphx/op/softmax.hpp>
 #include <migraphx/op/argmax.hpp>
 #include <migraphx/op/argmin.hpp>
+#include <migraphx/operators.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/register_op.hpp>
 #include <migraphx/par_dfor.hpp>
 #include <migraphx/cpu/gemm.hpp>
+#include <migraphx/cpu/convolution.hpp>
+#include <migraphx/cpu/allocate.hpp>
+#include <migraphx/cpu/concat.hpp>
+#include <migraphx/cpu/copy.hpp>
+#include <migraphx/cpu/gather.hpp>
+#include <migraphx/cpu/pointwise.hpp>
+#include <migraphx/cpu/softmax.hpp>
+#include <migraphx/cpu/reduce.hpp>
 #include <unordered_map>
 #include <utility>
 
@@ -71,11 +82,19 @@ struct cpu_batch_norm_inference
 
     std::string name() const { return "cpu::batch_norm_inference"; }
 
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
 
     argument compute(context&, const shape& output_shape, std::vector<argument> args) const
     {
-        argument output{output_shape};
+        argument output = args.back();
 
         double epsilon           = op.epsilon;
         auto input               = args[0];
@@ -135,10 +154,18 @@ struct cpu_lrn
     }
 
     std::string name() const { return "cpu::lrn"; }
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
     argument compute(context&, shape output_shape, std::vector<argument> args) const
     {
-        argument result{output_shape};
+        argument result = args.back();
         visit_all(result, args[0])([&](auto output, auto input) {
             int n_batch         = output_shape.lens()[0];
             int channels        = output_shape.lens()[1];
@@ -169,7 +196,7 @@ struct cpu_lrn
 };
 
 template <class Op>
-struct cpu_convolution
+struct cpu_deconvolution
 {
     Op op;
 
@@ -180,64 +207,18 @@ struct cpu_convolution
     }
 
     std::string name() const { return "cpu::" + op.name(); }
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, shape output_shape, std::vector<argument> args) const
+    shape compute_shape(std::vector<shape> inputs) const
     {
-        argument result{output_shape};
-        result.visit([&](auto output) {
-            using type = typename decltype(output)::value_type;
-            visit_all(args[0], args[1])([&](auto input, auto weights) {
-                auto in   = input.get_shape().lens();
-                auto in_h = in[2];
-                auto in_w = in[3];
-
-                auto wei   = weights.get_shape().lens();
-                auto wei_n = wei[0];
-                auto wei_c = wei[1];
-                auto wei_h = wei[2];
-                auto wei_w = wei[3];
-
-                par_dfor(output_shape.lens()[0],
-                         output_shape.lens()[1],
-                         output_shape.lens()[2],
-                         output_shape.lens()[3])(
-                    [&](std::size_t o, std::size_t w, std::size_t i, std::size_t j) {
-                        const auto start_x  = i * op.stride[0] - op.padding[0];
-                        const auto start_y  = j * op.stride[1] - op.padding[1];
-                        const auto group_id = w / (wei_n / op.group);
-
-                        type acc = type{0};
-                        dfor(wei_c, wei_h, wei_w)([&](std::size_t k, std::size_t x, std::size_t y) {
-                            const auto in_x  = start_x + x;
-                            const auto in_y  = start_y + y;
-                            const auto in_ch = group_id * wei_c + k;
-                            if(in_x >= 0 && in_x < in_h && in_y >= 0 && in_y < in_w)
-                                acc += input(o, in_ch, in_x, in_y) * weights(w, k, x, y);
-                        });
-                        output(o, w, i, j) = acc;
-                    });
-            });
-        });
-        return result;
+        inputs.pop_back();
+        return op.compute_shape(inputs);
     }
-};
-
-template <class Op>
-struct cpu_deconvolution
-{
-    Op op;
-
-    template <class Self, class F>
-    static auto reflect(Self& self, F f)
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
     {
-        return migraphx::reflect(self.op, f);
+        return shapes.size() - 1;
     }
-
-    std::string name() const { return "cpu::" + op.name(); }
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
     argument compute(context&, shape output_shape, std::vector<argument> args) const
     {
-        argument result{output_shape};
+        argument result = args.back();
         visit_all(result, args[0], args[1])([&](auto output, auto input, auto weights) {
             using type = typename decltype(output)::value_type;
 
@@ -294,11 +275,19 @@ struct cpu_im2col
     }
 
     static std::string name() { return "cpu::im2col"; }
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
 
     argument compute(context&, const shape& output_shape, std::vector<argument> args) const
     {
-        argument result{output_shape};
+        argument result    = args.back();
         auto input_shape   = args[0].get_shape();
         auto weights_shape = args[1].get_shape();
         visit_all(result, args[0])([&](auto col, auto input) {
@@ -381,10 +370,18 @@ struct cpu_pooling
     }
 
     std::string name() const { return "cpu::pooling_" + Op::name(); }
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
     argument compute(context&, const shape& output_shape, std::vector<argument> args) const
     {
-        argument result{output_shape};
+        argument result = args.back();
         visit_all(result, args[0])([&](auto output, auto input) {
             using type = typename decltype(output)::value_type;
             auto in_h  = input.get_shape().lens()[2];
@@ -427,12 +424,23 @@ struct cpu_pooling
 struct cpu_op
 {
     operation op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.op, "op"));
+    }
+
     std::string name() const { return "cpu::" + op.name(); }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
     argument compute(context&, const shape& output_shape, const std::vector<argument>& args) const
     {
         return op.compute(output_shape, args);
     }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return op.output_alias(shapes);
+    }
     friend bool operator==(const cpu_op& x, const cpu_op& y) { return x.op == y.op; }
     friend bool operator==(const cpu_op& x, const operation& y)
     {
@@ -443,9 +451,9 @@ struct cpu_op
     friend bool operator==(const operation& x, const cpu_op& y) { return y == x; }
 };
 
-struct cpu_pad
+struct cpu_contiguous
 {
-    op::pad op;
+    op::contiguous op;
 
     template <class Self, class F>
     static auto reflect(Self& self, F f)
@@ -454,74 +462,89 @@ struct cpu_pad
     }
 
     std::string name() const { return "cpu::contiguous"; }
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    shape compute_shape(std::vector<shape> inputs) const
     {
-        assert(output_shape.standard());
-        argument result{output_shape};
-        result.visit([&](auto output) { std::fill(output.begin(), output.end(), op.value); });
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    argument compute(context&, const shape&, std::vector<argument> args) const
+    {
+        argument result = args.back();
+        strided_copy(result, args[0]);
+        return result;
+    }
+};
 
-        visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(input.get_shape(), [&](const auto& idx) {
-                std::vector<std::size_t> new_idx(idx.size());
-                std::transform(
-                    idx.begin(), idx.end(), op.pads.begin(), new_idx.begin(), [](auto i, auto j) {
-                        return i + j;
-                    });
-                output(new_idx.begin(), new_idx.end()) = input(idx.begin(), idx.end());
-            });
-        });
+struct cpu_gather
+{
+    op::gather op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
 
+    std::string name() const { return "cpu::gather"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    argument compute(context&, const shape&, std::vector<argument> args) const
+    {
+        auto n          = args[0].get_shape().lens().size();
+        auto axis       = (op.axis < 0) ? op.axis + n : op.axis;
+        argument result = args.back();
+        gather(result, args[0], args[1], axis);
         return result;
     }
 };
 
-struct cpu_gemm
+struct cpu_pad
 {
-    op::dot op;
+    op::pad op;
 
     template <class Self, class F>
     static auto reflect(Self& self, F f)
     {
         return migraphx::reflect(self.op, f);
     }
-    std::string name() const { return "cpu::dot"; }
-    shape compute_shape(const std::vector<shape>& inputs) const
+
+    std::string name() const { return "cpu::pad"; }
+    shape compute_shape(std::vector<shape> inputs) const
     {
-        if(inputs.size() == 3)
-        {
-            auto c_shape = inputs.at(2);
-            check_shapes{{c_shape}}.not_broadcasted();
-        }
+        inputs.pop_back();
         return op.compute_shape(inputs);
     }
-
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
     argument compute(context&, const shape& output_shape, std::vector<argument> args) const
     {
-        argument result{output_shape};
-        // 3 inputs, it is alpha * A * B + beta * C, then
-        // A and B are matrices, and C is of the same shape as A * B
-        if(args.size() == 3)
-        {
-            // no need to consider the value of args[2]
-            if(op.beta == 0.0f)
-            {
-                result.visit([&](auto output) { std::fill(output.begin(), output.end(), 0); });
-            }
-            else
-            {
-                visit_all(result, args[2])([&](auto output, auto input) {
-                    std::copy(input.begin(), input.end(), output.begin());
-                });
-            }
-
-            migemm(result, args[0], args[1], op.alpha, op.beta);
-
-            return result;
-        }
+        assert(output_shape.standard());
+        argument result = args.back();
+        result.visit([&](auto output) { std::fill(output.begin(), output.end(), op.value); });
 
-        // 2 input arguments
-        migemm(result, args[0], args[1], op.alpha, 0.0f);
+        visit_all(result, args[0])([&](auto output, auto input) {
+            shape_for_each(input.get_shape(), [&](const auto& idx) {
+                std::vector<std::size_t> new_idx(idx.size());
+                std::transform(
+                    idx.begin(), idx.end(), op.pads.begin(), new_idx.begin(), [](auto i, auto j) {
+                        return i + j;
+                    });
+                output(new_idx.begin(), new_idx.end()) = input(idx.begin(), idx.end());
+            });
+        });
 
         return result;
     }
@@ -538,8 +561,9 @@ struct cpu_quant_gemm
     }
 
     std::string name() const { return "cpu::quant_dot"; }
-    shape compute_shape(const std::vector<shape>& inputs) const
+    shape compute_shape(std::vector<shape> inputs) const
     {
+        inputs.pop_back();
         if(inputs.size() == 3)
         {
             auto c_shape = inputs.at(2);
@@ -547,25 +571,18 @@ struct cpu_quant_gemm
         }
         return op.compute_shape(inputs);
     }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
 
-    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    argument compute(context&, const shape&, std::vector<argument> args) const
     {
-        argument result{output_shape};
+        argument result = args.back();
+        args.pop_back();
         // 3 inputs, it is alpha * A * B + beta * C, then
         // A and B are matrices, and C is of the same shape to A * B
-
-        // first, convert the args[0] and args[1] from int8_t to int32_t
-        argument arg_0{{shape::int32_type, {args.at(0).get_shape().lens()}}};
-        argument arg_1{{shape::int32_type, {args.at(1).get_shape().lens()}}};
-        arg_0.visit([&](auto output) {
-            args.at(0).visit(
-                [&](auto input) { std::copy(input.begin(), input.end(), output.begin()); });
-        });
-
-        arg_1.visit([&](auto output) {
-            args.at(1).visit(
-                [&](auto input) { std::copy(input.begin(), input.end(), output.begin()); });
-        });
+        // The int8 inputs are accumulated directly into the int32 result
 
         if(args.size() == 3)
         {
@@ -581,13 +598,13 @@ struct cpu_quant_gemm
                 });
             }
 
-            migemm(result, arg_0, arg_1, op.alpha, op.beta);
+            migemm(result, args[0], args[1], op.alpha, op.beta);
 
             return result;
         }
 
         // 2 input arguments
-        migemm(result, arg_0, arg_1, op.alpha, int32_t{0});
+        migemm(result, args[0], args[1], op.alpha, int32_t{0});
 
         return result;
     }
@@ -628,25 +645,29 @@ struct cpu_unary
     std::string name() const { return op.name(); }
     shape compute_shape(const std::vector<shape>& inputs) const
     {
-        check_shapes{inputs}.has(1);
+        check_shapes{inputs}.has(2);
         auto s = inputs.at(0);
         return {s.type(), s.lens()};
     }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
 
-    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    argument compute(context&, const shape&, std::vector<argument> args) const
     {
-        argument result{output_shape};
-        visit_all(result, args[0])([&](auto output, auto input) {
-            assert(input.get_shape().standard());
-            std::transform(input.begin(), input.end(), output.begin(), op.fcn());
-        });
+        argument result = args.back();
+        visit_all(result, args[0])(
+            [&](auto output, auto input) { pointwise(op.fcn(), output, input); });
 
         return result;
     }
 };
 
+// Unary and binary operators computed with the multi-threaded pointwise kernel
+// instead of the reference implementation
 template <class Op>
-struct cpu_softmax
+struct cpu_pointwise
 {
     Op op;
 
@@ -655,57 +676,147 @@ struct cpu_softmax
     {
         return migraphx::reflect(self.op, f);
     }
-
     std::string name() const { return "cpu::" + op.name(); }
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    shape compute_shape(std::vector<shape> inputs) const
     {
-        argument result{output_shape};
-        auto batch_lens    = output_shape.lens();
-        int64_t tuned_axis = (op.axis < 0) ? op.axis + args[0].get_shape().lens().size() : op.axis;
-        std::size_t n_dims = batch_lens[tuned_axis];
-        batch_lens[tuned_axis] = 1;
-        shape batch_shape{shape::int32_type, batch_lens};
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
 
-        visit_all(result, args[0])([&](auto output, auto input) {
-            using value_type = typename decltype(input)::value_type;
-            std::vector<value_type> batch_max(batch_shape.elements(),
-                                              std::numeric_limits<value_type>::lowest());
-            std::vector<value_type> batch_sum(batch_shape.elements(), value_type(0));
-            par_for(batch_shape.elements(), [&](auto i) {
-                auto idx = batch_shape.multi(i);
-                for(std::size_t j = 0; j < n_dims; ++j)
-                {
-                    idx[tuned_axis] = j;
-                    batch_max[i]    = std::max(batch_max[i], input(idx.begin(), idx.end()));
-                }
+    argument compute(context&, const shape&, std::vector<argument> args) const
+    {
+        argument result = args.back();
+        args.pop_back();
+        compute_impl(op, result, args);
+        return result;
+    }
 
-                for(std::size_t j = 0; j < n_dims; ++j)
-                {
-                    idx[tuned_axis]   = j;
-                    std::size_t index = output_shape.index(idx);
-                    output[index]     = std::exp(input[index] - batch_max[i]);
-                }
+    private:
+    template <class T>
+    static void compute_impl(const op::binary<T>& x,
+                             const argument& result,
+                             const std::vector<argument>& args)
+    {
+        visit_all(result, args[0], args[1])([&](auto output, auto a, auto b) {
+            pointwise(static_cast<const T&>(x).apply(), output, a, b);
+        });
+    }
 
-                for(std::size_t j = 0; j < n_dims; ++j)
-                {
-                    idx[tuned_axis] = j;
-                    batch_sum[i] += output(idx.begin(), idx.end());
-                }
+    template <class T>
+    static void
+    compute_impl(const op::unary<T>& x, const argument& result, const std::vector<argument>& args)
+    {
+        visit_all(result, args[0])([&](auto output, auto input) {
+            pointwise(static_cast<const T&>(x).apply(), output, input);
+        });
+    }
 
-                for(std::size_t j = 0; j < n_dims; ++j)
-                {
-                    idx[tuned_axis] = j;
-                    output(idx.begin(), idx.end()) =
-                        op.output()(output(idx.begin(), idx.end()), batch_sum[i]);
-                }
-            });
+    // The output type of convert is different from its input type
+    static void
+    compute_impl(const op::convert& x, const argument& result, const std::vector<argument>& args)
+    {
+        result.visit([&](auto output) {
+            args[0].visit([&](auto input) { pointwise(x.apply(), output, input); });
         });
+    }
+};
+
+template <class Op>
+struct cpu_softmax
+{
+    Op op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
 
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    argument compute(context&, const shape&, std::vector<argument> args) const
+    {
+        argument result    = args.back();
+        int64_t tuned_axis = (op.axis < 0) ? op.axis + args[0].get_shape().lens().size() : op.axis;
+        softmax(result, args[0], tuned_axis, std::is_same<Op, op::logsoftmax>{});
         return result;
     }
 };
 
+template <class Op>
+struct cpu_reduce
+{
+    Op op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+    argument compute(context&, const shape&, std::vector<argument> args) const
+    {
+        reduce(op.name(), args.back(), args[0]);
+        return args.back();
+    }
+};
+
+MIGRAPHX_REGISTER_OP(cpu_batch_norm_inference)
+MIGRAPHX_REGISTER_OP(cpu_lrn)
+MIGRAPHX_REGISTER_OP(cpu_convolution<op::convolution>)
+MIGRAPHX_REGISTER_OP(cpu_convolution<op::quant_convolution>)
+MIGRAPHX_REGISTER_OP(cpu_deconvolution<op::deconvolution>)
+MIGRAPHX_REGISTER_OP(cpu_im2col)
+MIGRAPHX_REGISTER_OP(cpu_pooling<max_pool>)
+MIGRAPHX_REGISTER_OP(cpu_pooling<avg_pool>)
+MIGRAPHX_REGISTER_OP(cpu_op)
+MIGRAPHX_REGISTER_OP(cpu_contiguous)
+MIGRAPHX_REGISTER_OP(cpu_gather)
+MIGRAPHX_REGISTER_OP(cpu_pad)
+MIGRAPHX_REGISTER_OP(cpu_gemm)
+MIGRAPHX_REGISTER_OP(cpu_quant_gemm)
+MIGRAPHX_REGISTER_OP(cpu_unary<leaky_relu_op>)
+MIGRAPHX_REGISTER_OP(cpu_unary<elu_op>)
+MIGRAPHX_REGISTER_OP(cpu_softmax<op::softmax>)
+MIGRAPHX_REGISTER_OP(cpu_softmax<op::logsoftmax>)
+MIGRAPHX_REGISTER_OP(cpu_reduce<op::reduce_max>)
+MIGRAPHX_REGISTER_OP(cpu_reduce<op::reduce_mean>)
+MIGRAPHX_REGISTER_OP(cpu_reduce<op::reduce_min>)
+MIGRAPHX_REGISTER_OP(cpu_reduce<op::reduce_prod>)
+MIGRAPHX_REGISTER_OP(cpu_reduce<op::reduce_sum>)
+MIGRAPHX_REGISTER_OP(cpu_pointwise<op::convert>)
+
+template <class... Ops>
+bool register_pointwise_ops(pointwise_op_list<Ops...>)
+{
+    each_args([](auto op) { register_op<cpu_pointwise<decltype(op)>>(); }, Ops{}...);
+    return true;
+}
+
+static const bool pointwise_ops_registered = register_pointwise_ops(pointwise_ops{});
+
 struct cpu_apply
 {
     program* prog;
@@ -723,29 +834,52 @@ struct cpu_apply
         return [this](instruction_ref ins) { apply_extend_op<T, Op>(ins); };
     }
 
+    template <class... Ops>
+    void add_pointwise_ops(pointwise_op_list<Ops...>)
+    {
+        each_args(
+            [&](auto op) {
+                using op_type        = decltype(op);
+                apply_map[op.name()] = extend_op<cpu_pointwise<op_type>, op_type>();
+            },
+            Ops{}...);
+    }
+
     void init()
     {
         apply_map["batch_norm_inference"] =
             extend_op<cpu_batch_norm_inference, op::batch_norm_inference>();
-        apply_map["convolution"] = extend_op<cpu_convolution<op::convolution>, op::convolution>();
+        apply_map["convolution"] =
+            extend_op<cpu_convolution<op::convolution>, op::convolution>();
         apply_map["deconvolution"] =
             extend_op<cpu_deconvolution<op::deconvolution>, op::deconvolution>();
         apply_map["dot"]       = extend_op<cpu_gemm, op::dot>();
         apply_map["quant_dot"] = extend_op<cpu_quant_gemm, op::quant_dot>();
         apply_map["quant_convolution"] =
             extend_op<cpu_convolution<op::quant_convolution>, op::quant_convolution>();
-        apply_map["elu"]        = extend_op<cpu_unary<elu_op>, op::elu>();
-        apply_map["im2col"]     = extend_op<cpu_im2col, op::im2col>();
-        apply_map["leaky_relu"] = extend_op<cpu_unary<leaky_relu_op>, op::leaky_relu>();
-        apply_map["logsoftmax"] = extend_op<cpu_softmax<op::logsoftmax>, op::logsoftmax>();
-        apply_map["lrn"]        = extend_op<cpu_lrn, op::lrn>();
-        apply_map["pad"]        = extend_op<cpu_pad, op::pad>();
-        apply_map["softmax"]    = extend_op<cpu_softmax<op::softmax>, op::softmax>();
+        apply_map["concat"]      = extend_op<cpu_concat, op::concat>();
+        apply_map["contiguous"]  = extend_op<cpu_contiguous, op::contiguous>();
+        apply_map["convert"]     = extend_op<cpu_pointwise<op::convert>, op::convert>();
+        apply_map["elu"]         = extend_op<cpu_unary<elu_op>, op::elu>();
+        apply_map["gather"]      = extend_op<cpu_gather, op::gather>();
+        apply_map["im2col"]      = extend_op<cpu_im2col, op::im2col>();
+        apply_map["leaky_relu"]  = extend_op<cpu_unary<leaky_relu_op>, op::leaky_relu>();
+        apply_map["logsoftmax"]  = extend_op<cpu_softmax<op::logsoftmax>, op::logsoftmax>();
+        apply_map["lrn"]         = extend_op<cpu_lrn, op::lrn>();
+        apply_map["pad"]         = extend_op<cpu_pad, op::pad>();
+        apply_map["reduce_max"]  = extend_op<cpu_reduce<op::reduce_max>, op::reduce_max>();
+        apply_map["reduce_mean"] = extend_op<cpu_reduce<op::reduce_mean>, op::reduce_mean>();
+        apply_map["reduce_min"]  = extend_op<cpu_reduce<op::reduce_min>, op::reduce_min>();
+        apply_map["reduce_prod"] = extend_op<cpu_reduce<op::reduce_prod>, op::reduce_prod>();
+        apply_map["reduce_sum"]  = extend_op<cpu_reduce<op::reduce_sum>, op::reduce_sum>();
+        apply_map["softmax"]     = extend_op<cpu_softmax<op::softmax>, op::softmax>();
+        add_pointwise_ops(pointwise_ops{});
     }
 
     void apply()
     {
         init();
+        pack_constant_weights();
         for(auto it : iterator_for(*prog))
         {
             if(it->name() == "pooling")
@@ -761,6 +895,62 @@ struct cpu_apply
                 apply_cpu_op(it);
             }
         }
+
+        copy_outputs();
+    }
+
+    // The b matrix of a dot is packed so its rows are contiguous. When it is
+    // constant this is done once here, by replacing it with a packed literal,
+    // instead of on every eval.
+    void pack_constant_weights()
+    {
+        for(auto ins : iterator_for(*prog))
+        {
+            if(ins->name() != "dot" and ins->name() != "quant_dot")
+                continue;
+            auto b = ins->inputs().at(1);
+            if(is_gemm_b_packed(b->get_shape()) or not b->can_eval())
+                continue;
+            auto packed = pack_gemm_b(b->eval());
+            auto l      = prog->add_literal(literal{packed.get_shape(), packed.data()});
+            instruction::replace_argument(ins, b, l);
+        }
+    }
+
+    instruction_ref insert_allocation(instruction_ref ins, const shape& s)
+    {
+        return prog->insert_instruction(ins, cpu_allocate{s});
+    }
+
+    std::vector<instruction_ref> with_allocation(instruction_ref ins)
+    {
+        auto inputs = ins->inputs();
+        inputs.push_back(insert_allocation(ins, ins->get_shape()));
+        return inputs;
+    }
+
+    // Allocations are placed in memory that is reused on every eval, so the
+    // program outputs that live there are copied out before being returned
+    void copy_outputs()
+    {
+        auto copy_output = [&](instruction_ref pos, instruction_ref ins) {
+            if(instruction::get_output_alias(ins)->name() != "cpu::allocate")
+                return ins;
+            return prog->insert_instruction(pos, cpu_copy{}, ins);
+        };
+        auto ret = std::prev(prog->end());
+        if(ret->name() == "@return")
+        {
+            auto outputs = ret->inputs();
+            std::transform(outputs.begin(), outputs.end(), outputs.begin(), [&](auto in) {
+                return copy_output(ret, in);
+            });
+            prog->replace_instruction(ret, builtin::returns{}, outputs);
+        }
+        else
+        {
+            copy_output(prog->end(), ret);
+        }
     }
 
     void apply_cpu_op(instruction_ref ins)
@@ -778,16 +968,16 @@ struct cpu_apply
     void apply_extend_op(instruction_ref ins)
     {
         auto&& op = any_cast<Op>(ins->get_operator());
-        prog->replace_instruction(ins, T{op}, ins->inputs());
+        prog->replace_instruction(ins, T{op}, with_allocation(ins));
     }
 
     void apply_pooling(instruction_ref ins)
     {
         auto&& op = any_cast<op::pooling>(ins->get_operator());
         if(op.mode == "max")
-            prog->replace_instruction(ins, cpu_pooling<max_pool>{op}, ins->inputs());
+            prog->replace_instruction(ins, cpu_pooling<max_pool>{op}, with_allocation(ins));
         else if(op.mode == "average")
-            prog->replace_instruction(ins, cpu_pooling<avg_pool>{op}, ins->inputs());
+            prog->replace_instruction(ins, cpu_pooling<avg_pool>{op}, with_allocation(ins));
     }
 };
 
@@ -0,0 +1,157 @@
+#include <migraphx/cpu/pointwise.hpp>
+#include <migraphx/par_for.hpp>
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+pointwise_dims collapse_dims(const std::vector<shape>& shapes)
+{
+    assert(not shapes.empty());
+    const auto& lens = shapes.front().lens();
+    assert(std::all_of(
+        shapes.begin(), shapes.end(), [&](const shape& s) { return s.lens() == lens; }));
+    pointwise_dims result;
+    result.strides.resize(shapes.size());
+    // Walk from the innermost dimension, merging a dimension into the previous
+    // one when every tensor steps over it by the length of the previous one
+    for(std::size_t d = lens.size(); d > 0; d--)
+    {
+        auto len = lens[d - 1];
+        if(len == 1)
+            continue;
+        bool merge = not result.lens.empty();
+        for(std::size_t k = 0; merge and k < shapes.size(); k++)
+            merge = shapes[k].strides()[d - 1] == result.strides[k].back() * result.lens.back();
+        if(merge)
+        {
+            result.lens.back() *= len;
+            continue;
+        }
+        result.lens.push_back(len);
+        for(std::size_t k = 0; k < shapes.size(); k++)
+            result.strides[k].push_back(shapes[k].strides()[d - 1]);
+    }
+    if(result.lens.empty())
+    {
+        result.lens.push_back(1);
+        for(auto& s : result.strides)
+            s.push_back(1);
+    }
+    std::reverse(result.lens.begin(), result.lens.end());
+    for(auto& s : result.strides)
+        std::reverse(s.begin(), s.end());
+    return result;
+}
+
+// Fewer elements than this are computed on the calling thread
+constexpr std::size_t pointwise_min_parallel = 16384;
+
+void pointwise_blocks(const std::vector<shape>& shapes, const pointwise_block_fn& f)
+{
+    const std::size_t n = shapes.size();
+    if(shapes.front().elements() == 0)
+        return;
+    auto dims         = collapse_dims(shapes);
+    std::size_t inner = dims.lens.back();
+    std::size_t outer = shapes.front().elements() / inner;
+    std::vector<std::size_t> inner_strides(n);
+    std::transform(dims.strides.begin(),
+                   dims.strides.end(),
+                   inner_strides.begin(),
+                   [](const auto& s) { return s.back(); });
+
+    std::size_t chunks    = (inner + pointwise_block_size - 1) / pointwise_block_size;
+    std::size_t tasks     = outer * chunks;
+    std::size_t task_size = std::min(inner, pointwise_block_size);
+    std::size_t min_grain = std::max<std::size_t>(1, pointwise_min_parallel / task_size);
+    std::vector<std::vector<std::size_t>> offsets(get_thread_pool().size(),
+                                                  std::vector<std::size_t>(n));
+    par_for(tasks, min_grain, [&](std::size_t task, std::size_t tid) {
+        std::size_t row   = task / chunks;
+        std::size_t start = (task % chunks) * pointwise_block_size;
+        std::size_t len   = std::min(inner - start, pointwise_block_size);
+        // Offset of the start of the block in each tensor
+        auto& offset = offsets[tid];
+        std::transform(inner_strides.begin(),
+                       inner_strides.end(),
+                       offset.begin(),
+                       [&](std::size_t s) { return start * s; });
+        for(std::size_t d = dims.lens.size() - 1; d > 0; d--)
+        {
+            std::size_t idx = row % dims.lens[d - 1];
+            row /= dims.lens[d - 1];
+            for(std::size_t k = 0; k < n; k++)
+                offset[k] += idx * dims.strides[k][d - 1];
+        }
+        f(tid, len, offset.data(), inner_strides.data());
+    });
+}
+
+template <class T, class Op>
+static void pointwise_kernel_impl(const op::unary<Op>& op,
+                                  std::size_t n,
+                                  char* const* data,
+                                  const std::size_t* strides)
+{
+    auto f        = static_cast<const Op&>(op).apply();
+    auto* out     = reinterpret_cast<T*>(data[0]);
+    const auto* x = reinterpret_cast<const T*>(data[1]);
+    if(strides[0] == 1 and strides[1] == 1)
+        detail::pointwise_contiguous(f, n, out, x);
+    else
+        detail::pointwise_strided(f, n, strides, out, x);
+}
+
+template <class T, class Op>
+static void pointwise_kernel_impl(const op::binary<Op>& op,
+                                  std::size_t n,
+                                  char* const* data,
+                                  const std::size_t* strides)
+{
+    auto f        = static_cast<const Op&>(op).apply();
+    auto* out     = reinterpret_cast<T*>(data[0]);
+    const auto* x = reinterpret_cast<const T*>(data[1]);
+    const auto* y = reinterpret_cast<const T*>(data[2]);
+    if(strides[0] == 1 and strides[1] == 1 and strides[2] == 1)
+        detail::pointwise_contiguous(f, n, out, x, y);
+    else
+        detail::pointwise_strided(f, n, strides, out, x, y);
+}
+
+template <class Op, class T>
+static void pointwise_kernel_fn(std::size_t n, char* const* data, const std::size_t* strides)
+{
+    pointwise_kernel_impl<T>(Op{}, n, data, strides);
+}
+
+template <class... Ops>
+static pointwise_kernel
+find_pointwise_kernel(pointwise_op_list<Ops...>, const std::string& name, shape::type_t t)
+{
+    pointwise_kernel result{};
+    each_args(
+        [&](auto op) {
+            if(op.name() != name)
+                return;
+            using op_type = decltype(op);
+            shape{t}.visit_type([&](auto as) {
+                result.run    = &pointwise_kernel_fn<op_type, typename decltype(as)::type>;
+                result.inputs = std::is_base_of<op::binary<op_type>, op_type>{} ? 2 : 1;
+            });
+        },
+        Ops{}...);
+    return result;
+}
+
+pointwise_kernel get_pointwise_kernel(const std::string& name, shape::type_t t)
+{
+    return find_pointwise_kernel(pointwise_ops{}, name, t);
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
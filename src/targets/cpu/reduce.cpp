@@ -0,0 +1,431 @@
+#include <migraphx/cpu/reduce.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/half.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+reduce_dims collapse_reduce_dims(const shape& input, const shape& output)
+{
+    const auto& lens = input.lens();
+    assert(lens.size() == output.lens().size());
+    // Dimensions from the innermost, with whether they are reduced
+    std::vector<std::pair<reduce_dim, bool>> dims;
+    for(std::size_t d = lens.size(); d > 0; d--)
+    {
+        auto len = lens[d - 1];
+        if(len == 1)
+            continue;
+        bool reduced = output.lens()[d - 1] == 1;
+        reduce_dim dim{len, input.strides()[d - 1], reduced ? 0 : output.strides()[d - 1]};
+        if(not dims.empty() and dims.back().second == reduced)
+        {
+            auto& prev = dims.back().first;
+            if(dim.in_stride == prev.in_stride * prev.len and
+               (reduced or dim.out_stride == prev.out_stride * prev.len))
+            {
+                prev.len *= len;
+                continue;
+            }
+        }
+        dims.emplace_back(dim, reduced);
+    }
+    reduce_dims result;
+    if(not dims.empty())
+        result.inner_reduced = dims.front().second;
+    // Reducing only axes of 1 is a copy, which reduces one element per output
+    if(std::none_of(dims.begin(), dims.end(), [](auto&& x) { return x.second; }))
+    {
+        dims.insert(dims.begin(), std::make_pair(reduce_dim{1, 1, 0}, true));
+        result.inner_reduced = true;
+    }
+    for(auto it = dims.rbegin(); it != dims.rend(); ++it)
+    {
+        if(it->second)
+            result.reduced.push_back(it->first);
+        else
+            result.kept.push_back(it->first);
+    }
+    return result;
+}
+
+// Elements reduced by one task
+constexpr std::size_t reduce_grain = 16384;
+// Contiguous runs longer than this are split in half and summed pairwise
+constexpr std::size_t reduce_pairwise_block = 256;
+// Outputs next to each other that are accumulated together
+constexpr std::size_t reduce_columns = 256;
+
+struct sum_kernel
+{
+    static constexpr bool sum = true;
+    template <class A>
+    static A init()
+    {
+        return A(0);
+    }
+    template <class A>
+    static A apply(A x, A y)
+    {
+        return x + y;
+    }
+};
+
+struct prod_kernel
+{
+    static constexpr bool sum = false;
+    template <class A>
+    static A init()
+    {
+        return A(1);
+    }
+    template <class A>
+    static A apply(A x, A y)
+    {
+        return x * y;
+    }
+};
+
+struct max_kernel
+{
+    static constexpr bool sum = false;
+    template <class A>
+    static A init()
+    {
+        return std::numeric_limits<A>::lowest();
+    }
+    template <class A>
+    static A apply(A x, A y)
+    {
+        return std::max(x, y);
+    }
+};
+
+struct min_kernel
+{
+    static constexpr bool sum = false;
+    template <class A>
+    static A init()
+    {
+        return std::numeric_limits<A>::max();
+    }
+    template <class A>
+    static A apply(A x, A y)
+    {
+        return std::min(x, y);
+    }
+};
+
+// Half is accumulated in float
+template <class T>
+using reduce_accumulator = std::conditional_t<std::is_same<T, half>{}, float, T>;
+
+// Combines partial results, with Kahan summation for floating point sums
+template <class Kernel, class A>
+struct reduce_accumulate
+{
+    static constexpr bool compensated = Kernel::sum and std::is_floating_point<A>{};
+
+    static void add(A& value, A& c, A x)
+    {
+        if(compensated)
+        {
+            A y   = x - c;
+            A t   = value + y;
+            c     = (t - value) - y;
+            value = t;
+        }
+        else
+        {
+            value = Kernel::apply(value, x);
+        }
+    }
+
+    A value = Kernel::template init<A>();
+    A c     = A(0);
+
+    void add(A x) { add(value, c, x); }
+};
+
+template <class Kernel, class A, class T>
+A reduce_contiguous(const T* x, std::size_t n)
+{
+    if(n > reduce_pairwise_block)
+    {
+        std::size_t h = (n / 2) & ~std::size_t{7};
+        return Kernel::apply(reduce_contiguous<Kernel, A>(x, h),
+                             reduce_contiguous<Kernel, A>(x + h, n - h));
+    }
+    // Independent accumulators so the loop is vectorized
+    std::array<A, 8> s;
+    s.fill(Kernel::template init<A>());
+    std::size_t i = 0;
+    for(; i + s.size() <= n; i += s.size())
+    {
+        for(std::size_t j = 0; j < s.size(); j++)
+            s[j] = Kernel::apply(s[j], A(x[i + j]));
+    }
+    A r = Kernel::template init<A>();
+    for(; i < n; i++)
+        r = Kernel::apply(r, A(x[i]));
+    for(std::size_t w = s.size() / 2; w > 0; w /= 2)
+    {
+        for(std::size_t j = 0; j < w; j++)
+            s[j] = Kernel::apply(s[j], s[j + w]);
+    }
+    return Kernel::apply(r, s[0]);
+}
+
+template <class Kernel, class A, class T>
+A reduce_strided(const T* x, std::size_t n, std::size_t stride)
+{
+    reduce_accumulate<Kernel, A> acc;
+    for(std::size_t i = 0; i < n; i++)
+        acc.add(A(x[i * stride]));
+    return acc.value;
+}
+
+static std::size_t elements(const std::vector<reduce_dim>& dims)
+{
+    return std::accumulate(dims.begin(), dims.end(), std::size_t{1}, [](auto n, auto&& d) {
+        return n * d.len;
+    });
+}
+
+// Offsets of the i-th element of the dimensions in the input and the output
+static void offsets_of(const std::vector<reduce_dim>& dims,
+                       std::size_t i,
+                       std::size_t& in_offset,
+                       std::size_t& out_offset)
+{
+    for(auto it = dims.rbegin(); it != dims.rend(); ++it)
+    {
+        std::size_t idx = i % it->len;
+        i /= it->len;
+        in_offset += idx * it->in_stride;
+        out_offset += idx * it->out_stride;
+    }
+}
+
+static std::size_t in_offset_of(const std::vector<reduce_dim>& dims, std::size_t i)
+{
+    std::size_t in_offset  = 0;
+    std::size_t out_offset = 0;
+    offsets_of(dims, i, in_offset, out_offset);
+    return in_offset;
+}
+
+// Split a reduction of rows between threads when there are fewer units of
+// outputs than threads
+static std::size_t get_splits(std::size_t units, std::size_t rows, std::size_t row_size)
+{
+    std::size_t n = get_thread_pool().size();
+    if(units >= n or rows * row_size < 2 * reduce_grain)
+        return 1;
+    return std::min((n + units - 1) / units, rows);
+}
+
+template <class Kernel, class T>
+struct reduce_engine
+{
+    using A       = reduce_accumulator<T>;
+    using combine = reduce_accumulate<Kernel, A>;
+
+    reduce_dims dims;
+    const T* in;
+    T* out;
+    bool mean;
+    std::size_t total;
+
+    T finish(A x) const
+    {
+        if(mean)
+            return T(x / A(total));
+        return T(x);
+    }
+
+    // Each output reduces contiguous runs along the innermost dimension
+    void inner() const
+    {
+        auto run       = dims.reduced.back();
+        auto rows_dims = dims.reduced;
+        rows_dims.pop_back();
+        std::size_t nout = elements(dims.kept);
+        std::size_t rows = elements(rows_dims);
+        // A run is split in pieces when there are not enough rows to split
+        std::size_t pieces = 1;
+        std::size_t splits = get_splits(nout, rows * run.len, 1);
+        if(rows < splits)
+            pieces = std::min(run.len / reduce_pairwise_block + 1, (splits + rows - 1) / rows);
+        std::size_t units = rows * pieces;
+        splits            = std::min(splits, units);
+        std::size_t piece = (run.len + pieces - 1) / pieces;
+
+        std::vector<A> partials(splits == 1 ? 0 : nout * splits);
+        std::size_t grain = std::max<std::size_t>(1, reduce_grain * splits / total);
+        par_for(nout * splits, grain, [&](auto i) {
+            std::size_t o          = i / splits;
+            std::size_t part       = i % splits;
+            std::size_t in_offset  = 0;
+            std::size_t out_offset = 0;
+            offsets_of(dims.kept, o, in_offset, out_offset);
+            combine acc;
+            for(std::size_t u = part * units / splits; u < (part + 1) * units / splits; u++)
+            {
+                std::size_t start = (u % pieces) * piece;
+                if(start >= run.len)
+                    continue;
+                std::size_t n = std::min(piece, run.len - start);
+                const T* x =
+                    in + in_offset + in_offset_of(rows_dims, u / pieces) + start * run.in_stride;
+                if(run.in_stride == 1)
+                    acc.add(reduce_contiguous<Kernel, A>(x, n));
+                else
+                    acc.add(reduce_strided<Kernel, A>(x, n, run.in_stride));
+            }
+            if(splits == 1)
+                out[out_offset] = finish(acc.value);
+            else
+                partials[i] = acc.value;
+        });
+        if(splits == 1)
+            return;
+        for(std::size_t o = 0; o < nout; o++)
+        {
+            std::size_t in_offset  = 0;
+            std::size_t out_offset = 0;
+            offsets_of(dims.kept, o, in_offset, out_offset);
+            combine acc;
+            for(std::size_t part = 0; part < splits; part++)
+                acc.add(partials[o * splits + part]);
+            out[out_offset] = finish(acc.value);
+        }
+    }
+
+    // Blocks of outputs along the innermost dimension accumulate a row of the
+    // input at a time
+    void outer() const
+    {
+        auto col        = dims.kept.back();
+        auto outer_dims = dims.kept;
+        outer_dims.pop_back();
+        std::size_t nouter = elements(outer_dims);
+        std::size_t blocks = (col.len + reduce_columns - 1) / reduce_columns;
+        std::size_t rows   = elements(dims.reduced);
+        std::size_t units  = nouter * blocks;
+        std::size_t splits = get_splits(units, rows, std::min(col.len, reduce_columns));
+
+        std::vector<A> partials(splits == 1 ? 0 : units * splits * reduce_columns);
+        std::size_t grain =
+            std::max<std::size_t>(1, reduce_grain / (rows * std::min(col.len, reduce_columns)));
+        par_for(units * splits, grain, [&](auto i) {
+            std::size_t unit       = i / splits;
+            std::size_t part       = i % splits;
+            std::size_t k0         = (unit % blocks) * reduce_columns;
+            std::size_t w          = std::min(reduce_columns, col.len - k0);
+            std::size_t in_offset  = k0 * col.in_stride;
+            std::size_t out_offset = k0 * col.out_stride;
+            offsets_of(outer_dims, unit / blocks, in_offset, out_offset);
+            std::array<A, reduce_columns> acc;
+            std::array<A, reduce_columns> c;
+            acc.fill(Kernel::template init<A>());
+            c.fill(A(0));
+            for(std::size_t r = part * rows / splits; r < (part + 1) * rows / splits; r++)
+            {
+                const T* x = in + in_offset + in_offset_of(dims.reduced, r);
+                if(col.in_stride == 1)
+                {
+                    for(std::size_t k = 0; k < w; k++)
+                        combine::add(acc[k], c[k], A(x[k]));
+                }
+                else
+                {
+                    for(std::size_t k = 0; k < w; k++)
+                        combine::add(acc[k], c[k], A(x[k * col.in_stride]));
+                }
+            }
+            if(splits == 1)
+            {
+                for(std::size_t k = 0; k < w; k++)
+                    out[out_offset + k * col.out_stride] = finish(acc[k]);
+            }
+            else
+            {
+                std::copy(acc.begin(), acc.begin() + w, partials.begin() + i * reduce_columns);
+            }
+        });
+        if(splits == 1)
+            return;
+        for(std::size_t unit = 0; unit < units; unit++)
+        {
+            std::size_t k0         = (unit % blocks) * reduce_columns;
+            std::size_t w          = std::min(reduce_columns, col.len - k0);
+            std::size_t in_offset  = 0;
+            std::size_t out_offset = k0 * col.out_stride;
+            offsets_of(outer_dims, unit / blocks, in_offset, out_offset);
+            for(std::size_t k = 0; k < w; k++)
+            {
+                combine acc;
+                for(std::size_t part = 0; part < splits; part++)
+                    acc.add(partials[(unit * splits + part) * reduce_columns + k]);
+                out[out_offset + k * col.out_stride] = finish(acc.value);
+            }
+        }
+    }
+
+    void run() const
+    {
+        if(dims.inner_reduced)
+            inner();
+        else
+            outer();
+    }
+};
+
+template <class Kernel, class T>
+void reduce_impl(
+    Kernel, const shape& out_shape, T* out, const shape& in_shape, const T* in, bool mean)
+{
+    if(out_shape.elements() == 0 or in_shape.elements() == 0)
+        return;
+    reduce_engine<Kernel, T> engine{collapse_reduce_dims(in_shape, out_shape),
+                                    in,
+                                    out,
+                                    mean,
+                                    in_shape.elements() / out_shape.elements()};
+    engine.run();
+}
+
+void reduce(const std::string& name, const argument& output, const argument& input)
+{
+    visit_all(output, input)([&](auto out, auto in) {
+        auto run = [&](auto kernel, bool mean) {
+            reduce_impl(
+                kernel, out.get_shape(), out.data(), in.get_shape(), in.data(), mean);
+        };
+        if(name == "reduce_sum")
+            run(sum_kernel{}, false);
+        else if(name == "reduce_mean")
+            run(sum_kernel{}, true);
+        else if(name == "reduce_max")
+            run(max_kernel{}, false);
+        else if(name == "reduce_min")
+            run(min_kernel{}, false);
+        else if(name == "reduce_prod")
+            run(prod_kernel{}, false);
+        else
+            MIGRAPHX_THROW("Unknown reduction: " + name);
+    });
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
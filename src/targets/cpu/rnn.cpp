@@ -0,0 +1,264 @@
+#include <migraphx/cpu/rnn.hpp>
+#include <migraphx/cpu/gemm.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+enum class rnn_activation
+{
+    sigmoid,
+    tanh,
+    relu
+};
+
+bool is_rnn_activation(const operation& op)
+{
+    return contains({"sigmoid", "tanh", "relu"}, op.name());
+}
+
+static std::vector<rnn_activation> get_activations(const std::vector<operation>& ops)
+{
+    std::vector<rnn_activation> result;
+    std::transform(ops.begin(), ops.end(), std::back_inserter(result), [](auto&& op) {
+        if(op.name() == "sigmoid")
+            return rnn_activation::sigmoid;
+        if(op.name() == "tanh")
+            return rnn_activation::tanh;
+        if(op.name() == "relu")
+            return rnn_activation::relu;
+        MIGRAPHX_THROW("RNN: unsupported activation function " + op.name());
+    });
+    return result;
+}
+
+static float activate(rnn_activation a, float x)
+{
+    switch(a)
+    {
+    case rnn_activation::sigmoid: return 1.0f / (1.0f + std::exp(-x));
+    case rnn_activation::tanh: return std::tanh(x);
+    case rnn_activation::relu: return std::max(0.0f, x);
+    }
+    return x;
+}
+
+static const float* as_floats(const argument& a)
+{
+    if(a.get_shape().type() != shape::float_type)
+        MIGRAPHX_THROW("RNN: only float is supported");
+    return reinterpret_cast<const float*>(a.data());
+}
+
+static argument matrix(const float* data, std::size_t rows, std::size_t cols)
+{
+    return {shape{shape::float_type, {rows, cols}}, const_cast<float*>(data)}; // NOLINT
+}
+
+// The transpose of the rows x cols matrix at data
+static argument transposed(const float* data, std::size_t rows, std::size_t cols)
+{
+    return {shape{shape::float_type, {cols, rows}, {1, cols}}, const_cast<float*>(data)}; // NOLINT
+}
+
+// Add the n values of b to the start of every row of x
+static void add_bias(float* x, std::size_t rows, std::size_t stride, const float* b, std::size_t n)
+{
+    for(std::size_t i = 0; i < rows; i++)
+        std::transform(b, b + n, x + i * stride, x + i * stride, std::plus<float>{});
+}
+
+/**
+ * Runs each direction of the operator, in parallel. make_step is called once
+ * for a direction with its index and the input multiplied by its weights,
+ * which has a row of gates * hidden values for every timestep and batch. It
+ * returns the function that computes one timestep from its row of the input,
+ * the previous hidden state and the output for the hidden state.
+ */
+template <class F>
+static void rnn_directions(op::rnn_direction direction,
+                           const argument& output,
+                           const std::vector<argument>& args,
+                           std::size_t gates,
+                           F make_step)
+{
+    const auto& lens       = args[0].get_shape().lens();
+    std::size_t seq_len    = lens[0];
+    std::size_t batch      = lens[1];
+    std::size_t input_size = lens[2];
+    std::size_t dirs       = args[2].get_shape().lens()[0];
+    std::size_t hidden     = args[2].get_shape().lens()[2];
+    std::size_t cols       = gates * hidden;
+    const float* x         = as_floats(args[0]);
+    const float* w         = as_floats(args[1]);
+    const float* ih        = as_floats(args[4]);
+    auto* y                = reinterpret_cast<float*>(output.data());
+    par_for(dirs, 1, [&](auto d) {
+        std::vector<float> xw(seq_len * batch * cols);
+        migemm(matrix(xw.data(), seq_len * batch, cols),
+               matrix(x, seq_len * batch, input_size),
+               transposed(w + d * cols * input_size, cols, input_size),
+               1.0f,
+               0.0f);
+        auto step    = make_step(d, xw.data());
+        bool forward = direction == op::rnn_direction::forward or
+                       (direction == op::rnn_direction::bidirectional and d == 0);
+        const float* h_prev = ih + d * batch * hidden;
+        for(std::size_t i = 0; i < seq_len; i++)
+        {
+            std::size_t t = forward ? i : seq_len - 1 - i;
+            float* h      = y + (t * dirs + d) * batch * hidden;
+            step(xw.data() + t * batch * cols, h_prev, h);
+            h_prev = h;
+        }
+    });
+}
+
+void rnn_sequence(const op::rnn& op, const argument& output, const std::vector<argument>& args)
+{
+    auto actv          = get_activations(op.actv_funcs);
+    std::size_t rows   = args[0].get_shape().lens()[0] * args[0].get_shape().lens()[1];
+    std::size_t batch  = args[0].get_shape().lens()[1];
+    std::size_t hidden = args[2].get_shape().lens()[2];
+    const float* r     = as_floats(args[2]);
+    const float* b     = as_floats(args[3]);
+    rnn_directions(op.direction, output, args, 1, [&](std::size_t d, float* xw) {
+        // Ht = f(Xt*(Wi^T) + Ht-1*(Ri^T) + Wbi + Rbi)
+        add_bias(xw, rows, hidden, b + d * 2 * hidden, hidden);
+        add_bias(xw, rows, hidden, b + d * 2 * hidden + hidden, hidden);
+        auto rt = pack_gemm_b(transposed(r + d * hidden * hidden, hidden, hidden));
+        auto f  = actv.at(d);
+        return [=](const float* xt, const float* h_prev, float* h) {
+            migemm(matrix(h, batch, hidden), matrix(h_prev, batch, hidden), rt, 1.0f, 0.0f);
+            for(std::size_t j = 0; j < batch * hidden; j++)
+                h[j] = activate(f, h[j] + xt[j]);
+        };
+    });
+}
+
+void rnn_sequence(const op::gru& op, const argument& output, const std::vector<argument>& args)
+{
+    auto actv         = get_activations(op.actv_funcs);
+    std::size_t rows  = args[0].get_shape().lens()[0] * args[0].get_shape().lens()[1];
+    std::size_t batch = args[0].get_shape().lens()[1];
+    std::size_t hs    = args[2].get_shape().lens()[2];
+    const float* r    = as_floats(args[2]);
+    const float* b    = as_floats(args[3]);
+    bool linear       = op.linear_before_reset != 0;
+    rnn_directions(op.direction, output, args, 3, [&](std::size_t d, float* xw) {
+        // The gates are in the order z, r, h. Both biases of z and r are
+        // added to the input, as is the input bias of h.
+        const float* bd = b + d * 6 * hs;
+        add_bias(xw, rows, 3 * hs, bd, 3 * hs);
+        add_bias(xw, rows, 3 * hs, bd + 3 * hs, 2 * hs);
+        const float* rbh = bd + 5 * hs;
+        const float* rd  = r + d * 3 * hs * hs;
+        // Without linear_before_reset Ht-1 is multiplied by rt before Rh, so
+        // it needs its own gemm
+        std::size_t cols = (linear ? 3 : 2) * hs;
+        auto rzr         = pack_gemm_b(transposed(rd, cols, hs));
+        auto rht         = linear ? argument{} : pack_gemm_b(transposed(rd + 2 * hs * hs, hs, hs));
+        auto f           = actv.at(2 * d);
+        auto g           = actv.at(2 * d + 1);
+        return [=, hr = std::vector<float>(batch * cols), rh = std::vector<float>(batch * hs)](
+                   const float* xt, const float* h_prev, float* h) mutable {
+            migemm(matrix(hr.data(), batch, cols), matrix(h_prev, batch, hs), rzr, 1.0f, 0.0f);
+            for(std::size_t n = 0; n < batch; n++)
+            {
+                const float* xn = xt + n * 3 * hs;
+                float* hn       = hr.data() + n * cols;
+                for(std::size_t k = 0; k < hs; k++)
+                {
+                    std::size_t j = n * hs + k;
+                    float zt      = activate(f, xn[k] + hn[k]);
+                    float rt      = activate(f, xn[hs + k] + hn[hs + k]);
+                    // Keep zt for the update, and rt or what it is applied to
+                    hn[k] = zt;
+                    if(linear)
+                        hn[hs + k] = rt * (hn[2 * hs + k] + rbh[k]);
+                    else
+                        rh[j] = rt * h_prev[j];
+                }
+            }
+            if(not linear)
+                migemm(matrix(h, batch, hs), matrix(rh.data(), batch, hs), rht, 1.0f, 0.0f);
+            // Ht = (1 - zt) (.) ht + zt (.) Ht-1
+            for(std::size_t n = 0; n < batch; n++)
+            {
+                const float* xn = xt + n * 3 * hs;
+                const float* hn = hr.data() + n * cols;
+                for(std::size_t k = 0; k < hs; k++)
+                {
+                    std::size_t j = n * hs + k;
+                    float hh      = linear ? hn[hs + k] : h[j] + rbh[k];
+                    float ht      = activate(g, xn[2 * hs + k] + hh);
+                    h[j]          = (1.0f - hn[k]) * ht + hn[k] * h_prev[j];
+                }
+            }
+        };
+    });
+}
+
+void rnn_sequence(const op::lstm& op, const argument& output, const std::vector<argument>& args)
+{
+    auto actv         = get_activations(op.actv_funcs);
+    std::size_t rows  = args[0].get_shape().lens()[0] * args[0].get_shape().lens()[1];
+    std::size_t batch = args[0].get_shape().lens()[1];
+    std::size_t hs    = args[2].get_shape().lens()[2];
+    const float* r    = as_floats(args[2]);
+    const float* b    = as_floats(args[3]);
+    const float* ic   = as_floats(args[5]);
+    const float* p    = as_floats(args[6]);
+    auto* cell        = reinterpret_cast<float*>(args[7].data());
+    rnn_directions(op.direction, output, args, 4, [&](std::size_t d, float* xw) {
+        // The gates are in the order i, o, f, c, and the peepholes i, o, f
+        add_bias(xw, rows, 4 * hs, b + d * 8 * hs, 4 * hs);
+        add_bias(xw, rows, 4 * hs, b + d * 8 * hs + 4 * hs, 4 * hs);
+        auto rt         = pack_gemm_b(transposed(r + d * 4 * hs * hs, 4 * hs, hs));
+        const float* pd = p + d * 3 * hs;
+        // The cell state is updated in place in the output for the last one
+        float* c = cell + d * batch * hs;
+        std::copy(ic + d * batch * hs, ic + (d + 1) * batch * hs, c);
+        auto f = actv.at(3 * d);
+        auto g = actv.at(3 * d + 1);
+        auto h = actv.at(3 * d + 2);
+        return [=, hr = std::vector<float>(batch * 4 * hs)](
+                   const float* xt, const float* h_prev, float* ht) mutable {
+            migemm(
+                matrix(hr.data(), batch, 4 * hs), matrix(h_prev, batch, hs), rt, 1.0f, 0.0f);
+            for(std::size_t n = 0; n < batch; n++)
+            {
+                const float* xn = xt + n * 4 * hs;
+                const float* hn = hr.data() + n * 4 * hs;
+                for(std::size_t k = 0; k < hs; k++)
+                {
+                    float& ct = c[n * hs + k];
+                    float it  = activate(f, xn[k] + hn[k] + pd[k] * ct);
+                    float ft  = activate(f, xn[2 * hs + k] + hn[2 * hs + k] + pd[2 * hs + k] * ct);
+                    float cc  = activate(g, xn[3 * hs + k] + hn[3 * hs + k]);
+                    // Ct = ft (.) Ct-1 + it (.) ct
+                    ct       = ft * ct + it * cc;
+                    float ot = activate(f, xn[hs + k] + hn[hs + k] + pd[hs + k] * ct);
+                    // Ht = ot (.) h(Ct)
+                    ht[n * hs + k] = ot * activate(h, ct);
+                }
+            }
+        };
+    });
+}
+
+MIGRAPHX_REGISTER_OP(cpu_rnn<op::rnn>)
+MIGRAPHX_REGISTER_OP(cpu_rnn<op::gru>)
+MIGRAPHX_REGISTER_OP(cpu_rnn<op::lstm>)
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,192 @@
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/register_op.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Runs an operator on a lane. The output of the operator is returned before
+// it is computed, so it must alias one of its inputs, as the allocations of
+// the cpu operators do. Other operators wait for their lane to be done and
+// run on the calling thread. Views, such as slices, only compute a pointer
+// that can be at an offset of their input, so they run on the calling thread
+// without waiting.
+struct lane_op
+{
+    operation op;
+    std::size_t lane     = 0;
+    bool view            = false;
+    std::ptrdiff_t alias = -1;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.op, "op"), f(self.lane, "lane"), f(self.view, "view"));
+    }
+
+    std::string name() const { return "cpu::lane"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        return op.compute_shape(inputs);
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return op.output_alias(shapes);
+    }
+    void
+    finalize(migraphx::context& ctx, const shape& output_shape, const std::vector<shape>& inputs)
+    {
+        any_cast<context>(ctx).create_lanes(lane + 1);
+        alias = op.output_alias(inputs);
+        if(has_finalize(op))
+            op.finalize(ctx, output_shape, inputs);
+    }
+    argument compute(migraphx::context& ctx,
+                     const shape& output_shape,
+                     const std::vector<argument>& args) const
+    {
+        auto* l = any_cast<context>(ctx).get_lane(lane);
+        if(l == nullptr or view)
+            return op.compute(ctx, output_shape, args);
+        if(alias < 0)
+        {
+            l->finish();
+            return op.compute(ctx, output_shape, args);
+        }
+        l->submit([op = op, output_shape, args](migraphx::context& lctx) {
+            op.compute(lctx, output_shape, args);
+        });
+        return {output_shape, args[alias].data};
+    }
+};
+
+struct record_event
+{
+    std::size_t event = 0;
+    std::size_t lane  = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"), f(self.lane, "lane"));
+    }
+    std::string name() const { return "cpu::record_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.get_event(event).record(ctx.get_lane(lane));
+        return {};
+    }
+
+    void finalize(context& ctx, const shape&, const std::vector<shape>&)
+    {
+        ctx.create_lanes(lane + 1);
+        ctx.create_events(event + 1);
+    }
+};
+
+struct wait_event
+{
+    std::size_t event = 0;
+    std::size_t lane  = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"), f(self.lane, "lane"));
+    }
+    std::string name() const { return "cpu::wait_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.get_event(event).wait(ctx.get_lane(lane));
+        return {};
+    }
+
+    void finalize(context& ctx, const shape&, const std::vector<shape>&)
+    {
+        ctx.create_lanes(lane + 1);
+        ctx.create_events(event + 1);
+    }
+};
+
+MIGRAPHX_REGISTER_OP(lane_op)
+MIGRAPHX_REGISTER_OP(record_event)
+MIGRAPHX_REGISTER_OP(wait_event)
+
+static std::size_t get_lane(instruction_ref ins)
+{
+    if(ins->name() != "cpu::lane")
+        return 0;
+    return any_cast<lane_op>(ins->get_operator()).lane;
+}
+
+// An operator whose output aliases an input that is not an allocation
+static bool is_view(instruction_ref ins)
+{
+    auto alias = instruction::get_output_alias(ins, true);
+    return alias != ins and alias->name() != "cpu::allocate" and alias->name() != "load";
+}
+
+std::size_t schedule_model::concurrency() const { return lanes; }
+void schedule_model::sched(program& p, instruction_ref ins, std::size_t n) const
+{
+    // Lane 0 runs the instructions in place
+    if(n == 0)
+        return;
+    p.replace_instruction(ins, lane_op{ins->get_operator(), n, is_view(ins)}, ins->inputs());
+}
+
+void schedule_model::wait(program& p, instruction_ref ins, std::size_t wait_id) const
+{
+    p.insert_instruction(ins, wait_event{wait_id, get_lane(ins)});
+}
+void schedule_model::record(program& p, instruction_ref ins, std::size_t wait_id) const
+{
+    p.insert_instruction(std::next(ins), record_event{wait_id, get_lane(ins)});
+}
+
+static std::unordered_map<std::string, std::size_t> create_weight_map()
+{
+    // The copy of the outputs waits for every lane, so it stays on the
+    // thread that evaluates the program
+    return {{"cpu::allocate", 0},
+            {"cpu::load_memory", 0},
+            {"cpu::copy", 0},
+            {"cpu::convolution", 8},
+            {"cpu::conv_bias", 8},
+            {"cpu::conv_bias_relu", 8},
+            {"cpu::quant_convolution", 8},
+            {"cpu::deconvolution", 8},
+            {"cpu::pooling_max", 4},
+            {"cpu::pooling_average", 4},
+            {"cpu::dot", 4},
+            {"cpu::dot_bias", 4},
+            {"cpu::dot_bias_relu", 4},
+            {"cpu::quant_dot", 4}};
+}
+
+static const std::unordered_map<std::string, std::size_t>& weight_map()
+{
+    static std::unordered_map<std::string, std::size_t> m = create_weight_map();
+    return m;
+}
+
+std::size_t schedule_model::weight(const operation& op) const
+{
+    if(weight_map().count(op.name()) == 0)
+    {
+        return 2;
+    }
+    return weight_map().at(op.name());
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
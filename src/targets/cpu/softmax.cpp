@@ -0,0 +1,243 @@
+#include <migraphx/cpu/softmax.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_ACCURATE_EXP)
+
+// Elements in the rows computed by one task
+constexpr std::size_t softmax_grain = 4096;
+// Rows computed together for an axis that is not innermost
+constexpr std::size_t softmax_columns = 64;
+
+// exp(x) for x <= 0, as a polynomial without branches or calls so loops over
+// it are vectorized. It is the range reduction and polynomial of cephes expf.
+// Results below the smallest normal float, and NaN, are flushed to about 0.
+static inline float fast_exp(float x)
+{
+    x = std::max(-87.3f, x);
+    // exp(x) = 2^n * exp(r), with r in [-ln(2)/2, ln(2)/2]
+    auto n  = static_cast<std::int32_t>(x * 1.44269504088896341f - 0.5f);
+    float r = x - static_cast<float>(n) * 0.693359375f;
+    r       = r - static_cast<float>(n) * -2.12194440e-4f;
+    float p = 1.9875691500e-4f;
+    p       = p * r + 1.3981999507e-3f;
+    p       = p * r + 8.3334519073e-3f;
+    p       = p * r + 4.1665795894e-2f;
+    p       = p * r + 1.6666665459e-1f;
+    p       = p * r + 5.0000001201e-1f;
+    p       = p * r * r + r + 1.0f;
+
+    auto bits   = static_cast<std::uint32_t>(n + 127) << 23u;
+    float scale = 0;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+struct std_exp
+{
+    template <class T>
+    T operator()(T x) const
+    {
+        return std::exp(x);
+    }
+};
+
+struct vector_exp
+{
+    float operator()(float x) const { return fast_exp(x); }
+};
+
+template <class T>
+using accumulator = std::conditional_t<std::is_same<T, double>{}, double, float>;
+
+using stride_one = std::integral_constant<std::size_t, 1>;
+
+// One row of n elements, read and written with the strides
+template <class T, class Exp, class S1, class S2>
+void softmax_row(Exp e, std::size_t n, const T* in, S1 in_stride, T* out, S2 out_stride, bool log)
+{
+    using acc_type = accumulator<T>;
+    acc_type m     = in[0];
+    for(std::size_t j = 1; j < n; j++)
+        m = std::max<acc_type>(m, in[j * in_stride]);
+    acc_type sum = 0;
+    if(log)
+    {
+        for(std::size_t j = 0; j < n; j++)
+            sum += e(acc_type(in[j * in_stride]) - m);
+        acc_type lsum = m + std::log(sum);
+        for(std::size_t j = 0; j < n; j++)
+            out[j * out_stride] = acc_type(in[j * in_stride]) - lsum;
+    }
+    else
+    {
+        for(std::size_t j = 0; j < n; j++)
+        {
+            acc_type x          = e(acc_type(in[j * in_stride]) - m);
+            out[j * out_stride] = x;
+            sum += x;
+        }
+        acc_type scale = acc_type(1) / sum;
+        for(std::size_t j = 0; j < n; j++)
+            out[j * out_stride] = acc_type(out[j * out_stride]) * scale;
+    }
+}
+
+// w rows of n elements that are next to each other, with stride between the
+// elements of a row
+template <class T, class Exp>
+void softmax_columns_block(
+    Exp e, std::size_t n, std::size_t w, std::size_t stride, const T* in, T* out, bool log)
+{
+    using acc_type = accumulator<T>;
+    std::array<acc_type, softmax_columns> m;
+    std::array<acc_type, softmax_columns> sum;
+    std::copy(in, in + w, m.begin());
+    for(std::size_t j = 1; j < n; j++)
+    {
+        const T* x = in + j * stride;
+        for(std::size_t k = 0; k < w; k++)
+            m[k] = std::max<acc_type>(m[k], x[k]);
+    }
+    std::fill(sum.begin(), sum.end(), acc_type(0));
+    for(std::size_t j = 0; j < n; j++)
+    {
+        const T* x = in + j * stride;
+        T* y       = out + j * stride;
+        for(std::size_t k = 0; k < w; k++)
+        {
+            acc_type v = e(acc_type(x[k]) - m[k]);
+            if(not log)
+                y[k] = v;
+            sum[k] += v;
+        }
+    }
+    for(std::size_t k = 0; k < w; k++)
+    {
+        if(log)
+            m[k] += std::log(sum[k]);
+        else
+            sum[k] = acc_type(1) / sum[k];
+    }
+    for(std::size_t j = 0; j < n; j++)
+    {
+        const T* x = in + j * stride;
+        T* y       = out + j * stride;
+        for(std::size_t k = 0; k < w; k++)
+        {
+            if(log)
+                y[k] = acc_type(x[k]) - m[k];
+            else
+                y[k] = acc_type(y[k]) * sum[k];
+        }
+    }
+}
+
+template <class T, class Exp>
+void softmax_impl(Exp e,
+                  const shape& out_shape,
+                  T* out,
+                  const shape& in_shape,
+                  const T* in,
+                  std::size_t axis,
+                  bool log)
+{
+    const auto& lens  = out_shape.lens();
+    std::size_t n     = lens[axis];
+    std::size_t outer = std::accumulate(
+        lens.begin(), lens.begin() + axis, std::size_t{1}, std::multiplies<std::size_t>{});
+    std::size_t inner = std::accumulate(
+        lens.begin() + axis + 1, lens.end(), std::size_t{1}, std::multiplies<std::size_t>{});
+    if(n == 0 or outer * inner == 0)
+        return;
+    std::size_t grain = std::max<std::size_t>(1, softmax_grain / n);
+    if(out_shape.standard() and in_shape.standard())
+    {
+        if(inner == 1)
+        {
+            par_for(outer, grain, [&](auto i) {
+                softmax_row(e, n, in + i * n, stride_one{}, out + i * n, stride_one{}, log);
+            });
+            return;
+        }
+        std::size_t blocks = (inner + softmax_columns - 1) / softmax_columns;
+        par_for(outer * blocks, std::max<std::size_t>(1, grain / softmax_columns), [&](auto i) {
+            std::size_t k      = (i % blocks) * softmax_columns;
+            std::size_t w      = std::min(softmax_columns, inner - k);
+            std::size_t offset = (i / blocks) * n * inner + k;
+            softmax_columns_block(e, n, w, inner, in + offset, out + offset, log);
+        });
+        return;
+    }
+    // Any other layout, such as a transposed or broadcasted input, is read
+    // with the strides of each tensor
+    par_for(outer * inner, grain, [&](auto i) {
+        std::size_t in_offset  = 0;
+        std::size_t out_offset = 0;
+        std::size_t r          = i;
+        for(std::size_t d = lens.size(); d > 0; d--)
+        {
+            auto dim = d - 1;
+            if(dim == axis)
+                continue;
+            std::size_t idx = r % lens[dim];
+            r /= lens[dim];
+            in_offset += idx * in_shape.strides()[dim];
+            out_offset += idx * out_shape.strides()[dim];
+        }
+        softmax_row(e,
+                    n,
+                    in + in_offset,
+                    in_shape.strides()[axis],
+                    out + out_offset,
+                    out_shape.strides()[axis],
+                    log);
+    });
+}
+
+template <class T>
+void softmax_dispatch(const shape& out_shape,
+                      T* out,
+                      const shape& in_shape,
+                      const T* in,
+                      std::size_t axis,
+                      bool log)
+{
+    softmax_impl(std_exp{}, out_shape, out, in_shape, in, axis, log);
+}
+
+static void softmax_dispatch(const shape& out_shape,
+                             float* out,
+                             const shape& in_shape,
+                             const float* in,
+                             std::size_t axis,
+                             bool log)
+{
+    if(enabled(MIGRAPHX_CPU_ACCURATE_EXP{}))
+        softmax_impl(std_exp{}, out_shape, out, in_shape, in, axis, log);
+    else
+        softmax_impl(vector_exp{}, out_shape, out, in_shape, in, axis, log);
+}
+
+void softmax(const argument& output, const argument& input, std::size_t axis, bool log)
+{
+    visit_all(output, input)([&](auto out, auto in) {
+        softmax_dispatch(out.get_shape(), out.data(), in.get_shape(), in.data(), axis, log);
+    });
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
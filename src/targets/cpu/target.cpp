@@ -1,30 +1,97 @@
 
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/cpu/lowering.hpp>
+#include <migraphx/cpu/fuse_ops.hpp>
+#include <migraphx/cpu/fuse_rnn.hpp>
+#include <migraphx/cpu/layout_nhwc.hpp>
+#include <migraphx/cpu/concat_opt.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/preallocate_param.hpp>
 #include <migraphx/pass.hpp>
 #include <migraphx/auto_contiguous.hpp>
 #include <migraphx/rewrite_rnn.hpp>
+#include <migraphx/rewrite_batchnorm.hpp>
+#include <migraphx/rewrite_pooling.hpp>
+#include <migraphx/simplify_algebra.hpp>
+#include <migraphx/simplify_reshapes.hpp>
+#include <migraphx/propagate_constant.hpp>
 #include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/eliminate_common_subexpression.hpp>
+#include <migraphx/eliminate_identity.hpp>
+#include <migraphx/eliminate_pad.hpp>
+#include <migraphx/eliminate_concat.hpp>
+#include <migraphx/memory_coloring.hpp>
+#include <migraphx/schedule.hpp>
+#include <migraphx/eliminate_allocation.hpp>
 #include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/thread_pool.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_SCHEDULE_PASS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_LANES)
+
 std::string target::name() const { return "cpu"; }
 
-std::vector<pass> target::get_passes(migraphx::context&, const compile_options&) const
+std::vector<pass> target::get_passes(migraphx::context&, const compile_options& options) const
 {
-    return {rewrite_rnn{},
-            dead_code_elimination{},
-            auto_contiguous{},
-            dead_code_elimination{},
-            lowering{},
-            dead_code_elimination{}};
+    auto lanes = value_of(MIGRAPHX_CPU_LANES{}, std::min<std::size_t>(4, get_thread_pool().size()));
+    std::vector<pass> passes;
+    auto add = [&](std::vector<pass> ps) { passes.insert(passes.end(), ps.begin(), ps.end()); };
+    if(options.optimization_level > 0)
+    {
+        add({dead_code_elimination{},
+             simplify_reshapes{},
+             dead_code_elimination{},
+             eliminate_identity{},
+             eliminate_pad{},
+             dead_code_elimination{},
+             rewrite_batchnorm{},
+             dead_code_elimination{},
+             fuse_rnn{},
+             dead_code_elimination{}});
+    }
+    add({rewrite_rnn{}, dead_code_elimination{}});
+    if(options.optimization_level > 0)
+    {
+        add({rewrite_pooling{},
+             dead_code_elimination{},
+             eliminate_common_subexpression{},
+             dead_code_elimination{},
+             simplify_algebra{},
+             dead_code_elimination{},
+             simplify_reshapes{},
+             dead_code_elimination{}});
+    }
+    add({auto_contiguous{}, dead_code_elimination{}});
+    if(options.optimization_level > 1)
+        add({propagate_constant{}, dead_code_elimination{}});
+    add({lowering{}, dead_code_elimination{}});
+    if(options.optimization_level > 0)
+    {
+        add({fuse_ops{},
+             dead_code_elimination{},
+             layout_nhwc{},
+             dead_code_elimination{},
+             eliminate_concat{concat_cpu_optimization{}},
+             dead_code_elimination{},
+             schedule{schedule_model{lanes}, not enabled(MIGRAPHX_DISABLE_SCHEDULE_PASS{})}});
+    }
+    add({memory_coloring{"cpu::allocate"},
+         eliminate_allocation{"cpu::allocate", 64},
+         preallocate_param{"scratch"},
+         preallocate_param{"memory"},
+         dead_code_elimination{}});
+    return passes;
 }
 
 argument target::allocate(const shape& s) const { return fill_argument(s, 0); }
 
+MIGRAPHX_REGISTER_TARGET(target)
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
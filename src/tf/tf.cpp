@@ -35,6 +35,7 @@ struct tf_parser
     program prog            = program();
     bool is_nhwc            = true;
     unsigned int batch_size = 1;
+    std::unordered_map<std::string, std::vector<std::size_t>> map_input_dims;
 
     std::unordered_map<std::string, op_func> ops;
 
@@ -1033,11 +1034,19 @@ struct tf_parser
             {
                 reorder_data(dims);
             }
+            std::vector<std::string> symbolic_dims(dims.size());
+            std::transform(dims.begin(), dims.end(), symbolic_dims.begin(), [](auto dim) {
+                return static_cast<int>(dim) <= 0 ? "?" : "";
+            });
             std::transform(dims.begin(), dims.end(), dims.begin(), [&](auto dim) {
                 return static_cast<int>(dim) <= 0 ? batch_size : dim;
             });
+            if(contains(map_input_dims, name))
+                dims = map_input_dims.at(name);
             shape s            = shape{shape_type, dims};
             instructions[name] = to_nhwc(prog.add_parameter(name, s));
+            if(symbolic_dims.size() == dims.size())
+                prog.set_symbolic_dims(name, symbolic_dims);
         }
         for(auto&& p : nodes)
         {
@@ -1394,7 +1403,8 @@ program parse_tf(const std::string& name, tf_options options)
     std::fstream input(name.c_str(), std::ios::in | std::ios::binary);
     tf_parser parser;
     parser.is_nhwc    = options.is_nhwc;
-    parser.batch_size = options.batch_size;
+    parser.batch_size     = options.batch_size;
+    parser.map_input_dims = options.map_input_dims;
 
 #ifndef NDEBUG
     // Log the program when it can't be parsed
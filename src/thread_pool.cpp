@@ -0,0 +1,244 @@
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct thread_pool_job
+{
+    const std::function<void(std::size_t)>* f = nullptr;
+    std::atomic<std::size_t> remaining{0};
+    std::mutex m;
+    std::condition_variable cv;
+    std::exception_ptr error = nullptr;
+};
+
+struct thread_pool_task
+{
+    thread_pool_job* job = nullptr;
+    std::size_t first    = 0;
+    std::size_t last     = 0;
+};
+
+struct thread_pool_queue
+{
+    std::mutex m;
+    std::deque<thread_pool_task> tasks;
+
+    void push(const thread_pool_task& t)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        tasks.push_front(t);
+    }
+
+    bool pop(thread_pool_task& t)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if(tasks.empty())
+            return false;
+        t = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+    bool steal(thread_pool_task& t)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if(tasks.empty())
+            return false;
+        t = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+};
+
+// The pool and queue index of the current thread when it is a worker
+thread_local const thread_pool_impl* current_pool = nullptr; // NOLINT
+thread_local std::size_t current_queue            = 0;       // NOLINT
+
+struct thread_pool_impl
+{
+    // Queue 0 is shared by external callers, queue i belongs to worker i
+    std::vector<thread_pool_queue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued{0};
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    bool stop = false;
+
+    thread_pool_impl(std::size_t n, bool pin) : queues(n)
+    {
+        // The calling thread always helps, so it takes the place of one worker
+        for(std::size_t i = 1; i < n; i++)
+        {
+            workers.emplace_back([=] { this->work(i, pin); });
+        }
+    }
+
+    ~thread_pool_impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stop = true;
+        }
+        sleep_cv.notify_all();
+        for(auto&& w : workers)
+            w.join();
+    }
+
+    std::size_t self() const { return current_pool == this ? current_queue : 0; }
+
+    void push(std::size_t q, const thread_pool_task& t)
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            queued++;
+        }
+        queues[q].push(t);
+        sleep_cv.notify_one();
+    }
+
+    bool next(std::size_t q, thread_pool_task& t)
+    {
+        bool found = queues[q].pop(t);
+        for(std::size_t i = 1; i < queues.size() and not found; i++)
+            found = queues[(q + i) % queues.size()].steal(t);
+        if(found)
+            queued--;
+        return found;
+    }
+
+    static void execute(const thread_pool_task& t)
+    {
+        auto* job = t.job;
+        try
+        {
+            for(std::size_t i = t.first; i < t.last; i++)
+                (*job->f)(i);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(job->m);
+            if(job->error == nullptr)
+                job->error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(job->m);
+        if(--job->remaining == 0)
+            job->cv.notify_all();
+    }
+
+    void work(std::size_t q, bool pin)
+    {
+        current_pool  = this;
+        current_queue = q;
+        if(pin)
+            pin_thread(q);
+        for(;;)
+        {
+            thread_pool_task t;
+            if(next(q, t))
+            {
+                execute(t);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleep_cv.wait(lock, [&] { return stop or queued > 0; });
+            if(stop and queued == 0)
+                return;
+        }
+    }
+
+    static void pin_thread(std::size_t q)
+    {
+#ifdef __linux__
+        auto ncores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(q % ncores, &cpuset);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#else
+        (void)q;
+#endif
+    }
+
+    void run(std::size_t n, std::size_t chunk, const std::function<void(std::size_t)>& f)
+    {
+        chunk = std::max<std::size_t>(chunk, 1);
+        thread_pool_job job;
+        job.f         = &f;
+        job.remaining = (n + chunk - 1) / chunk;
+        // Nested calls keep their work on the current worker's queue so it
+        // is picked up first by this thread and only stolen by idle workers
+        const bool nested = current_pool == this;
+        const auto q      = self();
+        std::size_t i     = 0;
+        for(std::size_t first = 0; first < n; first += chunk, i++)
+        {
+            thread_pool_task t{&job, first, std::min(n, first + chunk)};
+            push(nested ? q : i % queues.size(), t);
+        }
+        // Help until every task of this job has been claimed
+        while(job.remaining > 0)
+        {
+            thread_pool_task t;
+            if(next(q, t))
+            {
+                execute(t);
+                continue;
+            }
+            break;
+        }
+        // The job lives on this stack, so wait for the last task to release it
+        std::unique_lock<std::mutex> lock(job.m);
+        job.cv.wait(lock, [&] { return job.remaining == 0; });
+        if(job.error != nullptr)
+            std::rethrow_exception(job.error);
+    }
+};
+
+thread_pool::thread_pool(std::size_t n, bool pin)
+    : impl(std::make_unique<thread_pool_impl>(std::max<std::size_t>(n, 1), pin))
+{
+}
+
+thread_pool::~thread_pool() noexcept = default;
+
+std::size_t thread_pool::size() const { return impl->queues.size(); }
+
+void thread_pool::run(std::size_t n,
+                      std::size_t chunk,
+                      const std::function<void(std::size_t)>& f)
+{
+    if(n == 0)
+        return;
+    if(size() == 1 or n <= chunk)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+    impl->run(n, chunk, f);
+}
+
+bool thread_pool::is_worker() const { return current_pool == impl.get(); }
+
+thread_pool& get_thread_pool()
+{
+    static thread_pool pool{value_of(MIGRAPHX_CPU_THREADS{}, std::thread::hardware_concurrency()),
+                            enabled(MIGRAPHX_CPU_PIN_THREADS{})};
+    return pool;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
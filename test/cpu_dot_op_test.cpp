@@ -1510,4 +1510,85 @@ TEST_CASE(quant_dot_3args_batch)
     }
 }
 
+TEST_CASE(dot_batch_transposed_b)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::float_type, {2, 3, 4}};
+    std::vector<float> a(a_shape.elements());
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 7) - 3;
+    migraphx::shape b_shape{migraphx::shape::float_type, {2, 5, 4}};
+    std::vector<float> b(b_shape.elements());
+    for(std::size_t i = 0; i < b.size(); i++)
+        b[i] = float(i % 5) - 2;
+    auto al = p.add_literal(migraphx::literal{a_shape, a});
+    auto bl = p.add_literal(migraphx::literal{b_shape, b});
+    auto bt = p.add_instruction(migraphx::op::transpose{{0, 2, 1}}, bl);
+    p.add_instruction(migraphx::op::dot{}, al, bt);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> gold = {8,  -1, -5, -4, 2,  -7, -5, 2,  14, -4, 6,  -2, -5, -3, 4,
+                               -9, 1,  16, 1,  -9, 4,  -3, -5, -2, 6,  -4, 14, 2,  -5, -7};
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(dot_batch_half)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::half_type, {2, 2, 3}};
+    std::vector<float> a(a_shape.elements());
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 4) - 1;
+    migraphx::shape b_shape{migraphx::shape::half_type, {2, 3, 2}};
+    std::vector<float> b(b_shape.elements());
+    for(std::size_t i = 0; i < b.size(); i++)
+        b[i] = float(i % 3);
+    auto al = p.add_literal(migraphx::literal{a_shape, a});
+    auto bl = p.add_literal(migraphx::literal{b_shape, b});
+    p.add_instruction(migraphx::op::dot{}, al, bl);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> gold = {1, 1, -2, 2, 3, -1, 4, 4};
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(dot_batch_broadcast_b)
+{
+    const std::size_t batch = 3;
+    const std::size_t m     = 20;
+    const std::size_t k     = 3;
+    const std::size_t n     = 300;
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::float_type, {batch, m, k}};
+    std::vector<float> a(a_shape.elements());
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 7) - 3;
+    migraphx::shape b_shape{migraphx::shape::float_type, {k, n}};
+    std::vector<float> b(b_shape.elements());
+    for(std::size_t i = 0; i < b.size(); i++)
+        b[i] = float(i % 5) - 2;
+    auto al = p.add_parameter("a", a_shape);
+    auto bl = p.add_literal(migraphx::literal{b_shape, b});
+    auto bb = p.add_instruction(migraphx::op::multibroadcast{{batch, k, n}}, bl);
+    p.add_instruction(migraphx::op::dot{}, al, bb);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({{"a", migraphx::argument{a_shape, a.data()}}}).back();
+
+    std::vector<float> gold(batch * m * n);
+    for(std::size_t bi = 0; bi < batch; bi++)
+        for(std::size_t i = 0; i < m; i++)
+            for(std::size_t j = 0; j < n; j++)
+                for(std::size_t kk = 0; kk < k; kk++)
+                    gold[(bi * m + i) * n + j] += a[(bi * m + i) * k + kk] * b[kk * n + j];
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
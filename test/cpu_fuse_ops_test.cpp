@@ -0,0 +1,154 @@
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/operators.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/target.hpp>
+#include "test.hpp"
+#include <functional>
+
+// Compile the program for the cpu without fusing any operators
+migraphx::program compile_unfused(migraphx::program p)
+{
+    migraphx::cpu::target t;
+    auto passes = t.get_passes(p.get_context(), {});
+    passes.erase(std::remove_if(passes.begin(),
+                                passes.end(),
+                                [](const auto& pass) { return pass.name() == "cpu::fuse_ops"; }),
+                 passes.end());
+    migraphx::run_passes(p, passes);
+    p.set_target(t);
+    return p;
+}
+
+bool has_op(const migraphx::program& p, const std::string& name)
+{
+    return std::any_of(
+        p.begin(), p.end(), [&](const migraphx::instruction& ins) { return ins.name() == name; });
+}
+
+std::vector<float> eval(const migraphx::program& p)
+{
+    migraphx::program::parameter_map m;
+    for(auto&& x : p.get_parameter_shapes())
+        m[x.first] = migraphx::generate_argument(x.second, std::hash<std::string>{}(x.first));
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+void check_fused(const migraphx::program& p, const std::string& name)
+{
+    auto unfused = compile_unfused(p);
+    auto fused   = p;
+    fused.compile(migraphx::cpu::target{});
+    EXPECT(has_op(fused, name));
+    EXPECT(not has_op(unfused, name));
+    EXPECT(migraphx::verify_range(eval(fused), eval(unfused)));
+}
+
+migraphx::program conv_bias(bool relu)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {2, 8, 9, 9}};
+    migraphx::shape ws{migraphx::shape::float_type, {16, 8, 3, 3}};
+    migraphx::shape bs{migraphx::shape::float_type, {16}};
+    auto x    = p.add_parameter("x", xs);
+    auto w    = p.add_parameter("w", ws);
+    auto b    = p.add_parameter("b", bs);
+    auto conv = p.add_instruction(migraphx::op::convolution{{1, 1}}, x, w);
+    auto bias = p.add_instruction(migraphx::op::broadcast{1, conv->get_shape().lens()}, b);
+    auto add  = p.add_instruction(migraphx::op::add{}, conv, bias);
+    if(relu)
+        p.add_instruction(migraphx::op::relu{}, add);
+    return p;
+}
+
+TEST_CASE(conv_bias_test) { check_fused(conv_bias(false), "cpu::conv_bias"); }
+
+TEST_CASE(conv_bias_relu_test) { check_fused(conv_bias(true), "cpu::conv_bias_relu"); }
+
+TEST_CASE(conv_1x1_bias_relu_test)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {1, 16, 7, 7}};
+    migraphx::shape ws{migraphx::shape::float_type, {32, 16, 1, 1}};
+    migraphx::shape bs{migraphx::shape::float_type, {32}};
+    auto x    = p.add_parameter("x", xs);
+    auto w    = p.add_parameter("w", ws);
+    auto b    = p.add_parameter("b", bs);
+    auto conv = p.add_instruction(migraphx::op::convolution{}, x, w);
+    auto bias = p.add_instruction(migraphx::op::broadcast{1, conv->get_shape().lens()}, b);
+    auto add  = p.add_instruction(migraphx::op::add{}, bias, conv);
+    p.add_instruction(migraphx::op::relu{}, add);
+    check_fused(p, "cpu::conv_bias_relu");
+}
+
+TEST_CASE(dot_bias_relu_test)
+{
+    migraphx::program p;
+    migraphx::shape as{migraphx::shape::float_type, {6, 5}};
+    migraphx::shape bs{migraphx::shape::float_type, {5, 7}};
+    migraphx::shape cs{migraphx::shape::float_type, {7}};
+    auto a    = p.add_parameter("a", as);
+    auto b    = p.add_parameter("b", bs);
+    auto c    = p.add_parameter("c", cs);
+    auto dot  = p.add_instruction(migraphx::op::dot{}, a, b);
+    auto bias = p.add_instruction(migraphx::op::broadcast{1, dot->get_shape().lens()}, c);
+    auto add  = p.add_instruction(migraphx::op::add{}, dot, bias);
+    p.add_instruction(migraphx::op::relu{}, add);
+    check_fused(p, "cpu::dot_bias_relu");
+}
+
+TEST_CASE(conv_bias_used_twice_test)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {1, 4, 5, 5}};
+    migraphx::shape ws{migraphx::shape::float_type, {4, 4, 3, 3}};
+    migraphx::shape bs{migraphx::shape::float_type, {4}};
+    auto x    = p.add_parameter("x", xs);
+    auto w    = p.add_parameter("w", ws);
+    auto b    = p.add_parameter("b", bs);
+    auto conv = p.add_instruction(migraphx::op::convolution{}, x, w);
+    auto bias = p.add_instruction(migraphx::op::broadcast{1, conv->get_shape().lens()}, b);
+    auto add  = p.add_instruction(migraphx::op::add{}, conv, bias);
+    p.add_instruction(migraphx::op::mul{}, add, conv);
+    p.compile(migraphx::cpu::target{});
+    EXPECT(not has_op(p, "cpu::conv_bias"));
+}
+
+TEST_CASE(pointwise_chain_test)
+{
+    migraphx::program p;
+    migraphx::shape s{migraphx::shape::float_type, {4, 3, 8, 8}};
+    auto x   = p.add_parameter("x", s);
+    auto y   = p.add_parameter("y", s);
+    auto add = p.add_instruction(migraphx::op::add{}, x, y);
+    auto mul = p.add_instruction(migraphx::op::mul{}, add, x);
+    auto tan = p.add_instruction(migraphx::op::tanh{}, mul);
+    p.add_instruction(migraphx::op::sub{}, y, tan);
+    check_fused(p, "cpu::fused_pointwise");
+    p.compile(migraphx::cpu::target{});
+    EXPECT(std::count_if(p.begin(), p.end(), [](const migraphx::instruction& ins) {
+               return ins.name() == "cpu::fused_pointwise";
+           }) == 1);
+}
+
+TEST_CASE(pointwise_chain_broadcast_test)
+{
+    migraphx::program p;
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4, 5}, {60, 1, 15, 3}};
+    migraphx::shape bs{migraphx::shape::float_type, {3}};
+    auto x    = p.add_parameter("x", s);
+    auto b    = p.add_parameter("b", bs);
+    auto bias = p.add_instruction(migraphx::op::broadcast{1, s.lens()}, b);
+    auto add  = p.add_instruction(migraphx::op::add{}, x, bias);
+    auto sig  = p.add_instruction(migraphx::op::sigmoid{}, add);
+    p.add_instruction(migraphx::op::mul{}, sig, add);
+    check_fused(p, "cpu::fused_pointwise");
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,158 @@
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/operators.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/cpu/convolution.hpp>
+#include "test.hpp"
+#include <functional>
+
+// Compile the program for the cpu without changing any layouts
+migraphx::program compile_nchw(migraphx::program p)
+{
+    migraphx::cpu::target t;
+    auto passes = t.get_passes(p.get_context(), {});
+    passes.erase(std::remove_if(passes.begin(),
+                                passes.end(),
+                                [](const auto& pass) { return pass.name() == "cpu::layout_nhwc"; }),
+                 passes.end());
+    migraphx::run_passes(p, passes);
+    p.set_target(t);
+    return p;
+}
+
+std::size_t count_op(const migraphx::program& p, const std::string& name)
+{
+    return std::count_if(
+        p.begin(), p.end(), [&](const migraphx::instruction& ins) { return ins.name() == name; });
+}
+
+std::vector<float> eval(const migraphx::program& p)
+{
+    migraphx::program::parameter_map m;
+    for(auto&& x : p.get_parameter_shapes())
+        m[x.first] = migraphx::generate_argument(x.second, std::hash<std::string>{}(x.first));
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+// Checks the number of contiguous copies that are left, and that the results
+// do not change
+void check_copies(const migraphx::program& p, std::size_t copies)
+{
+    auto nchw = compile_nchw(p);
+    auto nhwc = p;
+    nhwc.compile(migraphx::cpu::target{});
+    EXPECT(count_op(nhwc, "cpu::contiguous") == copies);
+    EXPECT(count_op(nchw, "cpu::contiguous") > copies);
+    EXPECT(migraphx::verify_range(eval(nhwc), eval(nchw)));
+}
+
+migraphx::instruction_ref to_nchw(migraphx::program& p, migraphx::instruction_ref ins)
+{
+    return p.add_instruction(migraphx::op::transpose{{0, 3, 1, 2}}, ins);
+}
+
+migraphx::instruction_ref to_nhwc(migraphx::program& p, migraphx::instruction_ref ins)
+{
+    return p.add_instruction(migraphx::op::transpose{{0, 2, 3, 1}}, ins);
+}
+
+TEST_CASE(conv_nhwc_test)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {2, 9, 9, 8}};
+    migraphx::shape ws{migraphx::shape::float_type, {16, 8, 3, 3}};
+    auto x    = p.add_parameter("x", xs);
+    auto w    = p.add_parameter("w", ws);
+    auto conv = p.add_instruction(migraphx::op::convolution{{1, 1}}, to_nchw(p, x), w);
+    p.add_instruction(migraphx::op::relu{}, to_nhwc(p, conv));
+    check_copies(p, 0);
+}
+
+// The layers of a model imported from tensorflow, where every operator is
+// wrapped in transposes and the bias is added in NHWC
+TEST_CASE(conv_bias_nhwc_layers_test)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {1, 12, 12, 4}};
+    migraphx::shape w1s{migraphx::shape::float_type, {8, 4, 3, 3}};
+    migraphx::shape w2s{migraphx::shape::float_type, {6, 8, 1, 1}};
+    migraphx::shape bs{migraphx::shape::float_type, {8}};
+    auto x     = p.add_parameter("x", xs);
+    auto w1    = p.add_parameter("w1", w1s);
+    auto w2    = p.add_parameter("w2", w2s);
+    auto b     = p.add_parameter("b", bs);
+    auto conv1 = p.add_instruction(migraphx::op::convolution{{1, 1}, {2, 2}}, to_nchw(p, x), w1);
+    auto y1    = to_nhwc(p, conv1);
+    auto bias  = p.add_instruction(migraphx::op::broadcast{3, y1->get_shape().lens()}, b);
+    auto add   = p.add_instruction(migraphx::op::add{}, y1, bias);
+    auto relu  = p.add_instruction(migraphx::op::relu{}, add);
+    auto conv2 = p.add_instruction(migraphx::op::convolution{}, to_nchw(p, relu), w2);
+    p.add_instruction(migraphx::op::contiguous{}, to_nhwc(p, conv2));
+    // The copy of the program output is kept
+    check_copies(p, 1);
+}
+
+TEST_CASE(conv_nchw_output_test)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {1, 7, 7, 8}};
+    migraphx::shape ws{migraphx::shape::float_type, {4, 8, 3, 3}};
+    auto x    = p.add_parameter("x", xs);
+    auto w    = p.add_parameter("w", ws);
+    auto conv = p.add_instruction(migraphx::op::convolution{}, to_nchw(p, x), w);
+    // The output of the convolution is used in NCHW, so it is not changed
+    p.add_instruction(migraphx::op::relu{}, conv);
+    check_copies(p, 0);
+}
+
+TEST_CASE(conv_nhwc_algorithm_test)
+{
+    migraphx::shape ws{migraphx::shape::float_type, {12, 3, 3, 3}};
+    auto w = migraphx::generate_argument(ws, 1);
+    for(int group : {1, 2})
+    {
+        for(std::size_t stride : {1, 2})
+        {
+            migraphx::op::convolution op{{1, 1}, {stride, stride}, {1, 2}};
+            op.group = group;
+            migraphx::shape xs{migraphx::shape::float_type, {2, 3 * std::size_t(group), 10, 11}};
+            auto x_nchw = migraphx::generate_argument(xs, 2);
+            auto xs_cl  = migraphx::cpu::make_channels_last(xs);
+            migraphx::argument x_nhwc{xs_cl};
+            x_nchw.visit([&](auto src) {
+                x_nhwc.visit([&](auto dst) {
+                    for(std::size_t i = 0; i < xs.elements(); i++)
+                        dst[i] = src[i];
+                });
+            });
+            auto os     = op.compute_shape({xs, ws});
+            auto params = migraphx::cpu::conv_params::from(op);
+            auto algo   = migraphx::cpu::select_conv_algorithm(
+                params, migraphx::cpu::make_channels_last(os), xs_cl, ws);
+            EXPECT(to_string(algo) == "nhwc");
+
+            migraphx::argument gold{os};
+            migraphx::cpu::conv2d(params, migraphx::cpu::conv_algorithm::naive, gold, x_nchw, w);
+            for(auto&& out_shape : {os, migraphx::cpu::make_channels_last(os)})
+            {
+                migraphx::argument result{out_shape};
+                migraphx::cpu::conv2d(params, algo, result, x_nhwc, w);
+                std::vector<float> r(os.elements());
+                std::vector<float> g;
+                result.visit([&](auto v) {
+                    for(std::size_t i = 0; i < r.size(); i++)
+                        r[i] = v[i];
+                });
+                gold.visit([&](auto v) { g.assign(v.begin(), v.end()); });
+                EXPECT(migraphx::verify_range(r, g));
+            }
+        }
+    }
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -1,12 +1,25 @@
 #include <iostream>
 #include <vector>
+#include <numeric>
+#include <sstream>
+#include <thread>
 #include <migraphx/literal.hpp>
 #include <migraphx/operators.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/quantization.hpp>
 #include <migraphx/cpu/target.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/softmax.hpp>
+#include <migraphx/cpu/reduce.hpp>
+#include <migraphx/cpu/concat.hpp>
+#include <migraphx/cpu/copy.hpp>
+#include <migraphx/cpu/gather.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/schedule.hpp>
 #include <migraphx/quantization.hpp>
 #include <migraphx/verify.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/shape_for_each.hpp>
 #include <migraphx/onnx.hpp>
 #include "test.hpp"
 #include <migraphx/half.hpp>
@@ -154,6 +167,63 @@ TEST_CASE(concat_test)
     }
 }
 
+TEST_CASE(concat_in_place_test)
+{
+    migraphx::program p;
+    migraphx::shape s1{migraphx::shape::float_type, {1, 3, 4, 4}};
+    migraphx::shape s2{migraphx::shape::float_type, {1, 5, 4, 4}};
+    auto x  = p.add_parameter("x", s1);
+    auto y  = p.add_parameter("y", s2);
+    auto rx = p.add_instruction(migraphx::op::relu{}, x);
+    auto ry = p.add_instruction(migraphx::op::relu{}, y);
+    p.add_instruction(migraphx::op::concat{1}, rx, ry);
+    p.compile(migraphx::cpu::target{});
+    // The relus write into the output of the concat
+    EXPECT(std::none_of(
+        p.begin(), p.end(), [](auto&& ins) { return ins.name() == "cpu::concat"; }));
+
+    migraphx::program::parameter_map m;
+    m["x"] = migraphx::generate_argument(s1, 1);
+    m["y"] = migraphx::generate_argument(s2, 2);
+    std::vector<float> gold;
+    for(auto&& name : {"x", "y"})
+        m[name].visit([&](auto v) {
+            std::transform(v.begin(), v.end(), std::back_inserter(gold), [](float a) {
+                return std::max(a, 0.0f);
+            });
+        });
+    std::vector<float> results_vector;
+    p.eval(m).back().visit(
+        [&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(concat_slabs_test)
+{
+    using migraphx::shape;
+    std::vector<migraphx::argument> inputs = {
+        migraphx::generate_argument(shape{shape::float_type, {2, 3, 5, 4}}, 1),
+        migraphx::generate_argument(shape{shape::float_type, {2, 3, 7, 4}}, 2),
+        migraphx::generate_argument(shape{shape::float_type, {2, 3, 1, 4}}, 3)};
+    // A transposed input
+    std::vector<migraphx::argument> transposed = {
+        inputs[0],
+        migraphx::generate_argument(shape{shape::float_type, {2, 3, 6, 4}, {1, 2, 24, 6}})};
+    for(auto&& args : {inputs, transposed})
+    {
+        migraphx::op::concat op{2};
+        std::vector<shape> shapes;
+        std::transform(args.begin(), args.end(), std::back_inserter(shapes), [](auto&& a) {
+            return a.get_shape();
+        });
+        auto os   = op.compute_shape(shapes);
+        auto gold = op.compute(os, args);
+        migraphx::argument result{os};
+        migraphx::cpu::concat(result, args, 2);
+        EXPECT(result == gold);
+    }
+}
+
 TEST_CASE(gather_test)
 {
     {
@@ -300,6 +370,46 @@ TEST_CASE(gather_test)
     }
 }
 
+TEST_CASE(gather_indices_test)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 500, 64}};
+    auto data = migraphx::generate_argument(s, 1);
+    std::vector<int64_t> indices{0, 499, -1, 17, -500, 250, 3};
+    for(int axis : {0, 1, 2, -1})
+    {
+        auto n = s.lens()[axis < 0 ? axis + 3 : axis];
+        std::vector<int64_t> ind;
+        std::transform(indices.begin(), indices.end(), std::back_inserter(ind), [&](auto i) {
+            return i % int64_t(n);
+        });
+        for(auto t : {migraphx::shape::int32_type, migraphx::shape::int64_type})
+        {
+            migraphx::shape is{t, {ind.size()}};
+            migraphx::argument ia{is};
+            ia.visit([&](auto v) { std::copy(ind.begin(), ind.end(), v.begin()); });
+            migraphx::op::gather op{axis};
+            auto os   = op.compute_shape({s, is});
+            auto gold = op.compute(os, {data, ia});
+            migraphx::argument result{os};
+            migraphx::cpu::gather(result, data, ia, axis < 0 ? axis + 3 : axis);
+            EXPECT(result == gold);
+        }
+    }
+}
+
+TEST_CASE(gather_out_of_range_test)
+{
+    migraphx::program p;
+    migraphx::shape s{migraphx::shape::float_type, {4, 8}};
+    auto a0 = p.add_parameter("data", s);
+    auto a1 = p.add_literal(migraphx::literal{{migraphx::shape::int32_type, {2}}, {1, 4}});
+    p.add_instruction(migraphx::op::gather{0}, a0, a1);
+    p.compile(migraphx::cpu::target{});
+    migraphx::program::parameter_map m;
+    m["data"] = migraphx::generate_argument(s);
+    EXPECT(test::throws([&] { p.eval(m); }));
+}
+
 TEST_CASE(squeeze_test)
 {
     {
@@ -914,6 +1024,48 @@ TEST_CASE(add_broadcast_test)
     }
 }
 
+TEST_CASE(add_transposed_test)
+{
+    migraphx::program p;
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto l1 = p.add_literal(migraphx::literal{s, {0, 1, 2, 3, 4, 5}});
+    auto l2 = p.add_literal(migraphx::literal{s, {0, 10, 20, 30, 40, 50}});
+    auto t1 = p.add_instruction(migraphx::op::transpose{{1, 0}}, l1);
+    auto t2 = p.add_instruction(migraphx::op::reshape{{3, 2}}, l2);
+    p.add_instruction(migraphx::op::add{}, t1, t2);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector(6);
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold = {0, 13, 21, 34, 42, 55};
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(add_broadcast_large_test)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::float_type, {4, 64, 33, 17}};
+    migraphx::shape b_shape{migraphx::shape::float_type, {64}};
+    std::vector<float> a_data(a_shape.elements());
+    std::iota(a_data.begin(), a_data.end(), 0);
+    std::vector<float> b_data(b_shape.elements());
+    std::iota(b_data.begin(), b_data.end(), 0);
+    auto l1 = p.add_literal(migraphx::literal{a_shape, a_data});
+    auto l2 = p.add_literal(migraphx::literal{b_shape, b_data});
+    auto l3 = p.add_instruction(migraphx::op::broadcast{1, a_shape.lens()}, l2);
+    auto l4 = p.add_instruction(migraphx::op::add{}, l1, l3);
+    p.add_instruction(migraphx::op::relu{}, l4);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(a_data.size());
+    std::size_t plane = 33 * 17;
+    for(std::size_t i = 0; i < gold.size(); i++)
+        gold[i] = a_data[i] + b_data[(i / plane) % 64];
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
 TEST_CASE(sub_test)
 {
     migraphx::program p;
@@ -1213,6 +1365,61 @@ TEST_CASE(softmax_test)
     EXPECT(migraphx::verify_range(results_vector, s));
 }
 
+// Softmax computed in double with the indices of the shape
+std::vector<float> softmax_reference(const migraphx::argument& arg, std::size_t axis, bool log)
+{
+    auto s    = arg.get_shape();
+    auto lens = s.lens();
+    std::vector<float> result(s.elements());
+    migraphx::shape out{migraphx::shape::float_type, lens};
+    arg.visit([&](auto input) {
+        migraphx::shape_for_each(out, [&](const auto& idx) {
+            if(idx[axis] != 0)
+                return;
+            auto row = idx;
+            std::vector<double> x(lens[axis]);
+            for(std::size_t j = 0; j < x.size(); j++)
+            {
+                row[axis] = j;
+                x[j]      = input(row.begin(), row.end());
+            }
+            double m   = *std::max_element(x.begin(), x.end());
+            double sum = 0;
+            for(auto v : x)
+                sum += std::exp(v - m);
+            for(std::size_t j = 0; j < x.size(); j++)
+            {
+                row[axis]              = j;
+                result[out.index(row)] = log ? x[j] - m - std::log(sum) : std::exp(x[j] - m) / sum;
+            }
+        });
+    });
+    return result;
+}
+
+TEST_CASE(softmax_layouts_test)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 4, 70}};
+    auto standard = migraphx::generate_argument(s, 1);
+    // A transposed view of a {70, 4, 3} tensor
+    migraphx::shape ts{migraphx::shape::float_type, {3, 4, 70}, {1, 3, 12}};
+    auto transposed = migraphx::generate_argument(ts, 2);
+    for(bool log : {false, true})
+    {
+        for(std::size_t axis = 0; axis < 3; axis++)
+        {
+            for(auto&& input : {standard, transposed})
+            {
+                migraphx::argument output{s};
+                migraphx::cpu::softmax(output, input, axis, log);
+                std::vector<float> result;
+                output.visit([&](auto o) { result.assign(o.begin(), o.end()); });
+                EXPECT(migraphx::verify_range(result, softmax_reference(input, axis, log)));
+            }
+        }
+    }
+}
+
 TEST_CASE(logsoftmax_test_axis_0)
 {
     migraphx::program p;
@@ -1669,6 +1876,139 @@ TEST_CASE(conv2d_padding_stride_test)
     EXPECT(migraphx::verify_range(results_vector, s));
 }
 
+TEST_CASE(conv2d_4x4_group_test)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::float_type, {1, 4, 4, 4}};
+    std::vector<float> a(a_shape.elements());
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 7) - 3;
+    auto al = p.add_literal(migraphx::literal{a_shape, a});
+
+    migraphx::shape w_shape{migraphx::shape::float_type, {4, 2, 3, 3}};
+    std::vector<float> w(w_shape.elements());
+    for(std::size_t i = 0; i < w.size(); i++)
+        w[i] = float(i % 5) - 2;
+    auto wl = p.add_literal(migraphx::literal{w_shape, w});
+
+    migraphx::op::convolution op;
+    op.padding  = {{1, 1}};
+    op.stride   = {{1, 1}};
+    op.dilation = {{1, 1}};
+    op.group    = 2;
+    p.add_instruction(op, al, wl);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> gold = {
+        -4,  -4,  4,   3,   -1,  -2,  9,   -11, 2,   14,  -3,  5,   -8,  11,  -3,  -10, 7,   0,
+        -3,  5,   -1,  -8,  0,   9,   -15, -11, 18,  -14, 6,   4,   5,   10,  5,   -3,  0,   7,
+        8,   -6,  -6,  7,   -9,  1,   8,   -11, 6,   -1,  10,  0,   3,   4,   -4,  -4,  11,  -11,
+        -5,  13,  6,   -8,  -9,  13,  -8,  0,   10,  -4};
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(conv2d_dilation_test)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::float_type, {1, 2, 6, 6}};
+    std::vector<float> a(a_shape.elements());
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 7) - 3;
+    auto al = p.add_literal(migraphx::literal{a_shape, a});
+
+    migraphx::shape w_shape{migraphx::shape::float_type, {2, 2, 3, 3}};
+    std::vector<float> w(w_shape.elements());
+    for(std::size_t i = 0; i < w.size(); i++)
+        w[i] = float(i % 5) - 2;
+    auto wl = p.add_literal(migraphx::literal{w_shape, w});
+
+    migraphx::op::convolution op;
+    op.padding  = {{1, 1}};
+    op.stride   = {{1, 1}};
+    op.dilation = {{2, 2}};
+    op.group    = 1;
+    p.add_instruction(op, al, wl);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> gold = {
+        -12, -4,  -10, 3,   9,   -11, -7,  -14, 17,  -1,  -11, -4,  -4,  18,  -3,  -3,  10,  0,
+        18,  8,   3,   0,   1,   19,  -18, -1,  0,   -5,  6,   -12, -4,  -11};
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(conv2d_1x1_test)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::float_type, {2, 3, 2, 3}};
+    std::vector<float> a(a_shape.elements());
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 7) - 3;
+    auto al = p.add_literal(migraphx::literal{a_shape, a});
+
+    migraphx::shape w_shape{migraphx::shape::float_type, {4, 3, 1, 1}};
+    std::vector<float> w(w_shape.elements());
+    for(std::size_t i = 0; i < w.size(); i++)
+        w[i] = float(i % 5) - 2;
+    auto wl = p.add_literal(migraphx::literal{w_shape, w});
+
+    migraphx::op::convolution op;
+    op.padding  = {{0, 0}};
+    op.stride   = {{1, 1}};
+    op.dilation = {{1, 1}};
+    op.group    = 1;
+    p.add_instruction(op, al, wl);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> gold = {
+        3,   7,   4,   1,   -2,  -5,  -1,  -14, 1,   2,   3,   4,   5,   5,   -2,  -2,  -2,  -2,
+        -14, -1,  5,   4,   3,   2,   -2,  -5,  -8,  3,   7,   4,   3,   4,   5,   -1,  -14, 1,
+        -2,  -2,  -2,  5,   5,   -2,  3,   2,   1,   -14, -1,  5};
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(conv2d_5x5_stride_test)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::float_type, {1, 2, 7, 7}};
+    std::vector<float> a(a_shape.elements());
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 11) - 5;
+    auto al = p.add_literal(migraphx::literal{a_shape, a});
+
+    migraphx::shape w_shape{migraphx::shape::float_type, {3, 2, 5, 5}};
+    std::vector<float> w(w_shape.elements());
+    for(std::size_t i = 0; i < w.size(); i++)
+        w[i] = float(i % 7) - 3;
+    auto wl = p.add_literal(migraphx::literal{w_shape, w});
+
+    migraphx::op::convolution op;
+    op.padding  = {{2, 2}};
+    op.stride   = {{2, 2}};
+    op.dilation = {{1, 1}};
+    op.group    = 1;
+    p.add_instruction(op, al, wl);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> gold = {
+        28,   -27,  -88,  -22,  -70,  -68,  69,   69,   -49,  132,  104,  -55,  79,   -30,  -89,
+        -18,  28,   54,   -58,  -48,  -31,  -110, -59,  69,   -81,  27,   133,  17,   49,   69,
+        -52,  -46,  14,   100,  14,   -46,  57,   -89,  -124, 13,   -64,  -92,  71,   89,   -2,
+        119,  13,   -53};
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
 TEST_CASE(quant_conv2d_test)
 {
     migraphx::program p;
@@ -1770,6 +2110,55 @@ TEST_CASE(quant_conv2d_padding_stride_test)
     EXPECT(migraphx::verify_range(results_vector, s));
 }
 
+TEST_CASE(quant_conv2d_1x1_test)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::int8_type, {2, 4, 3, 3}};
+    std::vector<int8_t> a(2 * 4 * 3 * 3);
+    std::iota(a.begin(), a.end(), 0);
+    auto al = p.add_literal(migraphx::literal{a_shape, a});
+    migraphx::shape c_shape{migraphx::shape::int8_type, {3, 4, 1, 1}};
+    std::vector<int8_t> c(3 * 4);
+    std::iota(c.begin(), c.end(), -6);
+    auto cl = p.add_literal(migraphx::literal{c_shape, c});
+    p.add_instruction(migraphx::op::quant_convolution{}, al, cl);
+    p.compile(migraphx::cpu::target{});
+    auto result            = p.eval({}).back();
+    std::vector<int32_t> s = {-198, -216, -234, -252, -270, -288, -306, -324, -342, 18,   16,
+                              14,   12,   10,   8,    6,    4,    2,    234,  248,  262,  276,
+                              290,  304,  318,  332,  346,  -846, -864, -882, -900, -918, -936,
+                              -954, -972, -990, -54,  -56,  -58,  -60,  -62,  -64,  -66,  -68,
+                              -70,  738,  752,  766,  780,  794,  808,  822,  836,  850};
+
+    std::vector<int32_t> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, s));
+}
+
+TEST_CASE(quant_conv2d_5x5_test)
+{
+    migraphx::program p;
+    migraphx::shape a_shape{migraphx::shape::int8_type, {1, 2, 6, 6}};
+    std::vector<int8_t> a(2 * 6 * 6);
+    std::iota(a.begin(), a.end(), 0);
+    auto al = p.add_literal(migraphx::literal{a_shape, a});
+    migraphx::shape c_shape{migraphx::shape::int8_type, {2, 2, 5, 5}};
+    std::vector<int8_t> c(2 * 2 * 5 * 5);
+    std::iota(c.begin(), c.end(), -50);
+    auto cl = p.add_literal(migraphx::literal{c_shape, c});
+    p.add_instruction(migraphx::op::quant_convolution{{{1, 1}}}, al, cl);
+    p.compile(migraphx::cpu::target{});
+    auto result            = p.eval({}).back();
+    std::vector<int32_t> s = {-12080, -16100, -17020, -14496, -20050, -26450, -27725, -23390,
+                              -26050, -34100, -35375, -29630, -27200, -35340, -36460, -30320,
+                              33520,  41900,  42980,  34304,  42950,  53550,  54775,  43610,
+                              48950,  60900,  62125,  49370,  37600,  46660,  47540,  37680};
+
+    std::vector<int32_t> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, s));
+}
+
 TEST_CASE(deconv_test)
 {
     migraphx::shape s{migraphx::shape::float_type, {1, 1, 3, 3}};
@@ -1846,6 +2235,46 @@ TEST_CASE(contiguous_test)
     EXPECT(migraphx::verify_range(results_vector, data));
 }
 
+// Copies input into an output with the shape and compares every element
+void check_strided_copy(const migraphx::shape& output_shape, const migraphx::argument& input)
+{
+    migraphx::argument output{output_shape};
+    migraphx::cpu::strided_copy(output, input);
+    bool same = true;
+    visit_all(output, input)([&](auto out, auto in) {
+        migraphx::shape_for_each(output_shape, [&](const auto& idx) {
+            same = same and out(idx.begin(), idx.end()) == in(idx.begin(), idx.end());
+        });
+    });
+    EXPECT(same);
+}
+
+TEST_CASE(contiguous_layouts_test)
+{
+    using migraphx::shape;
+    std::vector<shape> inputs = {
+        // A transposed matrix, with a tail that is not a whole tile
+        shape{shape::float_type, {70, 45}, {1, 70}},
+        // NCHW to NHWC and NHWC to NCHW
+        shape{shape::float_type, {2, 5, 6, 33}, {990, 1, 165, 5}},
+        shape{shape::float_type, {2, 33, 5, 6}, {990, 1, 198, 33}},
+        // A slice, where only the rows are contiguous
+        shape{shape::float_type, {3, 4, 10}, {80, 20, 1}},
+        // Broadcasted
+        shape{shape::float_type, {4, 3, 8}, {0, 1, 0}},
+        shape{shape::float_type, {3, 100000}, {100000, 1}},
+        shape{shape::int8_type, {16, 40, 3}, {3, 48, 1}},
+        shape{shape::half_type, {9, 7, 2}, {2, 18, 1}}};
+    for(auto&& s : inputs)
+    {
+        auto input = migraphx::generate_argument(s, 3);
+        check_strided_copy({s.type(), s.lens()}, input);
+    }
+    // Into a transposed output
+    check_strided_copy({shape::float_type, {40, 70}, {1, 40}},
+                       migraphx::generate_argument({shape::float_type, {40, 70}}, 4));
+}
+
 TEST_CASE(identity_test)
 {
     migraphx::program p;
@@ -2326,6 +2755,83 @@ TEST_CASE(reduce_max_axis02)
     EXPECT(results_vector == gold);
 }
 
+// Reduction computed in double with the indices of the shape
+std::vector<float> reduce_reference(const std::string& name,
+                                    const migraphx::argument& arg,
+                                    const std::vector<std::size_t>& axes)
+{
+    auto lens = arg.get_shape().lens();
+    for(auto axis : axes)
+        lens[axis] = 1;
+    migraphx::shape out{migraphx::shape::float_type, lens};
+    std::size_t n = arg.get_shape().elements() / out.elements();
+    std::vector<double> result(out.elements(), name == "reduce_max" ? -1e30 : 0);
+    if(name == "reduce_min")
+        std::fill(result.begin(), result.end(), 1e30);
+    arg.visit([&](auto input) {
+        migraphx::shape_for_each(arg.get_shape(), [&](const auto& idx) {
+            auto out_idx = idx;
+            for(auto axis : axes)
+                out_idx[axis] = 0;
+            double x = input(idx.begin(), idx.end());
+            auto& r  = result[out.index(out_idx)];
+            if(name == "reduce_max")
+                r = std::max(r, x);
+            else if(name == "reduce_min")
+                r = std::min(r, x);
+            else if(name == "reduce_mean")
+                r += x / n;
+            else
+                r += x;
+        });
+    });
+    return {result.begin(), result.end()};
+}
+
+TEST_CASE(reduce_layouts_test)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 5, 300}};
+    auto standard = migraphx::generate_argument(s, 1);
+    // A transposed view of a {300, 5, 4} tensor
+    migraphx::shape ts{migraphx::shape::float_type, {4, 5, 300}, {1, 4, 20}};
+    auto transposed = migraphx::generate_argument(ts, 2);
+    std::vector<std::vector<std::size_t>> all_axes = {
+        {0}, {1}, {2}, {0, 1}, {0, 2}, {1, 2}, {0, 1, 2}};
+    for(const std::string name : {"reduce_sum", "reduce_mean", "reduce_max", "reduce_min"})
+    {
+        for(auto&& axes : all_axes)
+        {
+            auto lens = s.lens();
+            for(auto axis : axes)
+                lens[axis] = 1;
+            for(auto&& input : {standard, transposed})
+            {
+                migraphx::argument output{{migraphx::shape::float_type, lens}};
+                migraphx::cpu::reduce(name, output, input);
+                std::vector<float> result;
+                output.visit([&](auto o) { result.assign(o.begin(), o.end()); });
+                EXPECT(migraphx::verify_range(result, reduce_reference(name, input, axes)));
+            }
+        }
+    }
+}
+
+TEST_CASE(reduce_sum_large_test)
+{
+    migraphx::program p;
+    migraphx::shape s{migraphx::shape::float_type, {1024, 1024}};
+    std::vector<float> data(s.elements(), 0.1f);
+    auto l0 = p.add_literal(migraphx::literal{s, data});
+    p.add_instruction(migraphx::op::reduce_sum{{0, 1}}, l0);
+    p.compile(migraphx::cpu::target{});
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    // Adding 0.1f one at a time in float is off by more than 1%
+    std::vector<float> gold{0.1f * s.elements()};
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
 TEST_CASE(sqdiff_test)
 {
     migraphx::program p;
@@ -2419,4 +2925,203 @@ TEST_CASE(op_capture)
     EXPECT(migraphx::verify_range(vec, cap_vec));
 }
 
+TEST_CASE(preallocated_memory_test)
+{
+    migraphx::program p;
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x  = p.add_parameter("x", s);
+    auto sm = p.add_instruction(migraphx::op::softmax{1}, x);
+    p.add_instruction(migraphx::op::leaky_relu{0.5f}, sm);
+    p.compile(migraphx::cpu::target{});
+    // The scratch memory is owned by the program, so only x has to be passed
+    EXPECT(p.get_parameter_shapes().size() == 1);
+
+    std::vector<float> a = {1, 2, 3, 4, 5, 6};
+    std::vector<float> b = {6, 5, 4, 3, 2, 1};
+    auto r1              = p.eval({{"x", migraphx::argument{s, a.data()}}}).back();
+    std::vector<float> v1;
+    r1.visit([&](auto output) { v1.assign(output.begin(), output.end()); });
+    auto r2 = p.eval({{"x", migraphx::argument{s, b.data()}}}).back();
+
+    // Results are not overwritten by later evals
+    std::vector<float> v2;
+    r1.visit([&](auto output) { v2.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(v1, v2));
+    std::vector<float> gold = {
+        0.0900306, 0.2447285, 0.6652410, 0.0900306, 0.2447285, 0.6652410};
+    EXPECT(migraphx::verify_range(v1, gold));
+}
+
+TEST_CASE(concurrent_session_test)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {1, 4, 8, 8}};
+    migraphx::shape ws{migraphx::shape::float_type, {8, 4, 3, 3}};
+    auto x    = p.add_parameter("x", xs);
+    auto w    = p.add_literal(migraphx::generate_literal(ws, 1));
+    auto conv = p.add_instruction(migraphx::op::convolution{{1, 1}}, x, w);
+    auto sm   = p.add_instruction(migraphx::op::softmax{1}, conv);
+    p.add_instruction(migraphx::op::tanh{}, sm);
+    p.compile(migraphx::cpu::target{});
+
+    const std::size_t n = 4;
+    std::vector<migraphx::argument> inputs;
+    std::vector<std::vector<float>> gold(n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        inputs.push_back(migraphx::generate_argument(xs, i));
+        p.eval({{"x", inputs[i]}}).back().visit(
+            [&](auto output) { gold[i].assign(output.begin(), output.end()); });
+    }
+
+    // Every thread reuses its session, while the others write their own
+    // scratch memory at the same time
+    std::vector<std::size_t> mismatches(n, 0);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        threads.emplace_back([&, i] {
+            auto s = p.create_session();
+            for(std::size_t j = 0; j < 20; j++)
+            {
+                auto k = (i + j) % n;
+                s.eval({{"x", inputs[k]}}).back().visit([&](auto output) {
+                    std::vector<float> result(output.begin(), output.end());
+                    if(not migraphx::verify_range(result, gold[k]))
+                        mismatches[i]++;
+                });
+            }
+        });
+    }
+    for(auto&& t : threads)
+        t.join();
+    EXPECT(std::all_of(mismatches.begin(), mismatches.end(), [](auto m) { return m == 0; }));
+}
+
+// Compile for the cpu with the branches scheduled on the given number of lanes
+migraphx::program compile_with_lanes(migraphx::program p, std::size_t lanes)
+{
+    migraphx::cpu::target t;
+    auto passes = t.get_passes(p.get_context(), {});
+    std::transform(
+        passes.begin(), passes.end(), passes.begin(), [&](const auto& pass) -> migraphx::pass {
+            if(pass.name() == "schedule")
+                return migraphx::schedule{migraphx::cpu::schedule_model{lanes}};
+            return pass;
+        });
+    migraphx::run_passes(p, passes);
+    p.set_target(t);
+    return p;
+}
+
+TEST_CASE(schedule_branches_test)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {1, 8, 16, 16}};
+    migraphx::shape ws1{migraphx::shape::float_type, {4, 8, 1, 1}};
+    migraphx::shape ws3{migraphx::shape::float_type, {4, 8, 3, 3}};
+    auto x   = p.add_parameter("x", xs);
+    auto w1  = p.add_literal(migraphx::generate_literal(ws1, 1));
+    auto w2  = p.add_literal(migraphx::generate_literal(ws3, 2));
+    auto w3  = p.add_literal(migraphx::generate_literal(ws1, 3));
+    auto c1  = p.add_instruction(migraphx::op::convolution{}, x, w1);
+    auto c2  = p.add_instruction(migraphx::op::convolution{{1, 1}}, x, w2);
+    auto r2  = p.add_instruction(migraphx::op::relu{}, c2);
+    auto mp  = p.add_instruction(migraphx::op::pooling{"max", {1, 1}, {1, 1}, {3, 3}}, x);
+    auto c3  = p.add_instruction(migraphx::op::convolution{}, mp, w3);
+    auto cat = p.add_instruction(migraphx::op::concat{1}, c1, r2, c3);
+    p.add_instruction(migraphx::op::tanh{}, cat);
+
+    auto serial   = compile_with_lanes(p, 1);
+    auto parallel = compile_with_lanes(p, 4);
+    auto has_op   = [](const migraphx::program& q, const std::string& name) {
+        return std::any_of(q.begin(), q.end(), [&](auto&& ins) { return ins.name() == name; });
+    };
+    EXPECT(not has_op(serial, "cpu::lane"));
+    EXPECT(has_op(parallel, "cpu::lane"));
+    EXPECT(has_op(parallel, "cpu::wait_event"));
+    // The events are reused by every eval
+    for(std::size_t i = 0; i < 3; i++)
+    {
+        auto arg = migraphx::generate_argument(xs, i);
+        std::vector<float> gold;
+        std::vector<float> result;
+        serial.eval({{"x", arg}}).back().visit(
+            [&](auto output) { gold.assign(output.begin(), output.end()); });
+        parallel.eval({{"x", arg}}).back().visit(
+            [&](auto output) { result.assign(output.begin(), output.end()); });
+        EXPECT(migraphx::verify_range(result, gold));
+    }
+}
+
+// Slices and transposes of the branches are views at an offset of their input
+TEST_CASE(schedule_views_test)
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {1, 16, 8, 8}};
+    migraphx::shape ws{migraphx::shape::float_type, {4, 8, 3, 3}};
+    auto x  = p.add_parameter("x", xs);
+    auto w1 = p.add_literal(migraphx::generate_literal(ws, 1));
+    auto w2 = p.add_literal(migraphx::generate_literal(ws, 2));
+    auto s1 = p.add_instruction(migraphx::op::slice{{1}, {8}, {16}}, x);
+    auto s2 = p.add_instruction(migraphx::op::slice{{1}, {0}, {8}}, x);
+    auto c1 = p.add_instruction(migraphx::op::convolution{{1, 1}}, s1, w1);
+    auto c2 = p.add_instruction(migraphx::op::convolution{{1, 1}}, s2, w2);
+    auto t2 = p.add_instruction(migraphx::op::transpose{{0, 1, 3, 2}}, c2);
+    auto r2 = p.add_instruction(migraphx::op::relu{}, t2);
+    p.add_instruction(migraphx::op::add{}, c1, r2);
+
+    auto serial   = compile_with_lanes(p, 1);
+    auto parallel = compile_with_lanes(p, 4);
+    auto arg      = migraphx::generate_argument(xs, 3);
+    std::vector<float> gold;
+    std::vector<float> result;
+    serial.eval({{"x", arg}}).back().visit(
+        [&](auto output) { gold.assign(output.begin(), output.end()); });
+    parallel.eval({{"x", arg}}).back().visit(
+        [&](auto output) { result.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(result, gold));
+}
+
+TEST_CASE(optimization_levels_test)
+{
+    migraphx::program p;
+    migraphx::shape s{migraphx::shape::float_type, {4, 6}};
+    auto x  = p.add_parameter("x", s);
+    auto l  = p.add_literal(migraphx::generate_literal(s, 1));
+    auto e  = p.add_instruction(migraphx::op::exp{}, l);
+    auto a1 = p.add_instruction(migraphx::op::add{}, x, e);
+    auto a2 = p.add_instruction(migraphx::op::add{}, x, e);
+    p.add_instruction(migraphx::op::mul{}, a1, a2);
+
+    auto arg = migraphx::generate_argument(s, 2);
+    std::vector<float> gold;
+    std::vector<migraphx::program> compiled;
+    for(std::size_t level : {0, 1, 2})
+    {
+        auto q = p;
+        migraphx::compile_options options;
+        options.optimization_level = level;
+        q.compile(migraphx::cpu::target{}, options);
+        std::vector<float> result;
+        q.eval({{"x", arg}}).back().visit(
+            [&](auto output) { result.assign(output.begin(), output.end()); });
+        if(level == 0)
+            gold = result;
+        EXPECT(migraphx::verify_range(result, gold));
+        compiled.push_back(q);
+    }
+    auto size    = [](const migraphx::program& q) { return std::distance(q.begin(), q.end()); };
+    auto has_exp = [](const migraphx::program& q) {
+        std::stringstream ss;
+        ss << q;
+        return ss.str().find("exp") != std::string::npos;
+    };
+    // The second add is removed and the operators are fused at level 1, and
+    // the exp of the literal is folded at level 2
+    EXPECT(size(compiled[0]) > size(compiled[1]));
+    EXPECT(has_exp(compiled[1]));
+    EXPECT(not has_exp(compiled[2]));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
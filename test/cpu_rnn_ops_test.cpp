@@ -7,9 +7,13 @@
 #include <migraphx/op/rnn_last_output.hpp>
 #include <migraphx/op/rnn_last_cell_output.hpp>
 #include <migraphx/op/abnormal_ops.hpp>
+#include <migraphx/op/elu.hpp>
+#include <migraphx/op/relu.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/verify.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/pass_manager.hpp>
 #include <migraphx/onnx.hpp>
 #include "test.hpp"
 
@@ -3446,4 +3450,112 @@ TEST_CASE(lstm_bidirectional_actv_func)
     }
 }
 
+// The hidden states, the last one and the last cell state, computed with the
+// fused kernels and with the graph that rewrite_rnn unrolls
+template <class Op>
+void check_fused_rnn(Op op, std::size_t gates, const std::string& fused_name)
+{
+    std::size_t batch_size  = 3;
+    std::size_t seq_len     = 5;
+    std::size_t hidden_size = op.hidden_size;
+    std::size_t input_size  = 6;
+    std::size_t num_dirct   = op.direction == migraphx::op::rnn_direction::bidirectional ? 2 : 1;
+    migraphx::shape in_shape{migraphx::shape::float_type, {seq_len, batch_size, input_size}};
+    migraphx::shape w_shape{migraphx::shape::float_type,
+                            {num_dirct, gates * hidden_size, input_size}};
+    migraphx::shape r_shape{migraphx::shape::float_type,
+                            {num_dirct, gates * hidden_size, hidden_size}};
+    migraphx::shape b_shape{migraphx::shape::float_type, {num_dirct, 2 * gates * hidden_size}};
+    migraphx::shape ih_shape{migraphx::shape::float_type, {num_dirct, batch_size, hidden_size}};
+    migraphx::shape pph_shape{migraphx::shape::float_type, {num_dirct, 3 * hidden_size}};
+    bool is_lstm = gates == 4;
+
+    for(std::string output : {"hidden_states", "rnn_last_output", "lstm_last_cell_output"})
+    {
+        if(output == "lstm_last_cell_output" and not is_lstm)
+            continue;
+        migraphx::program p;
+        auto literal = [&](const migraphx::shape& s, unsigned long seed) {
+            return p.add_literal(migraphx::generate_literal(s, seed));
+        };
+        std::vector<migraphx::instruction_ref> args = {literal(in_shape, 1),
+                                                       literal(w_shape, 2),
+                                                       literal(r_shape, 3),
+                                                       literal(b_shape, 4),
+                                                       p.add_instruction(migraphx::op::undefined{}),
+                                                       literal(ih_shape, 5)};
+        if(is_lstm)
+        {
+            args.push_back(literal(ih_shape, 6));
+            args.push_back(literal(pph_shape, 7));
+        }
+        auto hs = p.add_instruction(op, args);
+        if(output == "rnn_last_output")
+            p.add_instruction(migraphx::op::rnn_last_output{}, hs);
+        else if(output == "lstm_last_cell_output")
+            p.add_instruction(migraphx::op::lstm_last_cell_output{}, hs);
+
+        auto unrolled = p;
+        migraphx::cpu::target t;
+        auto passes = t.get_passes(unrolled.get_context(), {});
+        passes.erase(
+            std::remove_if(passes.begin(),
+                           passes.end(),
+                           [](const auto& pass) { return pass.name() == "cpu::fuse_rnn"; }),
+            passes.end());
+        migraphx::run_passes(unrolled, passes);
+        unrolled.set_target(t);
+        p.compile(t);
+        EXPECT(std::any_of(p.begin(), p.end(), [&](auto&& ins) {
+            return ins.name() == fused_name;
+        }));
+        EXPECT(std::none_of(unrolled.begin(), unrolled.end(), [&](auto&& ins) {
+            return ins.name() == fused_name;
+        }));
+
+        std::vector<float> result;
+        std::vector<float> gold;
+        p.eval({}).back().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+        unrolled.eval({}).back().visit([&](auto v) { gold.assign(v.begin(), v.end()); });
+        EXPECT(migraphx::verify_range(result, gold));
+    }
+}
+
+TEST_CASE(rnn_fused)
+{
+    using migraphx::op::rnn_direction;
+    for(auto dirct : {rnn_direction::forward, rnn_direction::reverse, rnn_direction::bidirectional})
+    {
+        check_fused_rnn(migraphx::op::rnn{7, {migraphx::op::relu{}}, dirct}, 1, "cpu::rnn");
+        for(int linear_before_reset : {0, 1})
+        {
+            check_fused_rnn(migraphx::op::gru{7, {}, dirct, 0.0f, linear_before_reset},
+                            3,
+                            "cpu::gru");
+        }
+        check_fused_rnn(migraphx::op::lstm{7, {}, dirct}, 4, "cpu::lstm");
+    }
+}
+
+TEST_CASE(rnn_unfused_actv_func)
+{
+    std::size_t hidden_size = 4;
+    migraphx::shape in_shape{migraphx::shape::float_type, {2, 1, 3}};
+    migraphx::shape w_shape{migraphx::shape::float_type, {1, hidden_size, 3}};
+    migraphx::shape r_shape{migraphx::shape::float_type, {1, hidden_size, hidden_size}};
+    migraphx::program p;
+    auto seq = p.add_literal(migraphx::generate_literal(in_shape, 1));
+    auto w   = p.add_literal(migraphx::generate_literal(w_shape, 2));
+    auto r   = p.add_literal(migraphx::generate_literal(r_shape, 3));
+    p.add_instruction(
+        migraphx::op::rnn{
+            hidden_size, {migraphx::op::elu{}}, migraphx::op::rnn_direction::forward},
+        seq,
+        w,
+        r);
+    p.compile(migraphx::cpu::target{});
+    // The kernels do not support elu, so the rnn is unrolled
+    EXPECT(std::none_of(p.begin(), p.end(), [](auto&& ins) { return ins.name() == "cpu::rnn"; }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
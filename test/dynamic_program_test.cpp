@@ -0,0 +1,105 @@
+#include <migraphx/dynamic_program.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/operators.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/verify.hpp>
+#include "test.hpp"
+
+// Computes x + relu(x) for x of shape {batch, 4}, and counts the times it is loaded
+migraphx::dynamic_program::loader make_loader(std::size_t& loads)
+{
+    return [&](const migraphx::input_dims& dims) {
+        loads++;
+        std::vector<std::size_t> lens = {1, 4};
+        if(dims.count("x") > 0)
+            lens = dims.at("x");
+        migraphx::program p;
+        auto x = p.add_parameter("x", {migraphx::shape::float_type, lens});
+        p.set_symbolic_dims("x", {"batch", ""});
+        auto r = p.add_instruction(migraphx::op::relu{}, x);
+        p.add_instruction(migraphx::op::add{}, x, r);
+        return p;
+    };
+}
+
+bool check_batch(migraphx::dynamic_program& dp, std::size_t batch)
+{
+    migraphx::shape s{migraphx::shape::float_type, {batch, 4}};
+    auto x      = migraphx::generate_argument(s, batch);
+    auto result = dp.eval({{"x", x}}).back();
+    if(result.get_shape().lens() != s.lens())
+        return false;
+    std::vector<float> gold;
+    x.visit([&](auto input) {
+        std::transform(input.begin(), input.end(), std::back_inserter(gold), [](float v) {
+            return v + std::max(v, 0.0f);
+        });
+    });
+    std::vector<float> output;
+    result.visit([&](auto r) { output.assign(r.begin(), r.end()); });
+    return migraphx::verify_range(output, gold);
+}
+
+TEST_CASE(dynamic_batch)
+{
+    std::size_t loads = 0;
+    migraphx::dynamic_program dp{make_loader(loads), migraphx::cpu::target{}};
+    EXPECT(loads == 1);
+    EXPECT(dp.get_symbolic_dims().at("x") == std::vector<std::string>{"batch", ""});
+    EXPECT(check_batch(dp, 2));
+    EXPECT(check_batch(dp, 3));
+    EXPECT(check_batch(dp, 2));
+    EXPECT(dp.size() == 2);
+    EXPECT(loads == 3);
+}
+
+TEST_CASE(dynamic_evict)
+{
+    std::size_t loads = 0;
+    migraphx::dynamic_options options;
+    options.capacity = 2;
+    migraphx::dynamic_program dp{make_loader(loads), migraphx::cpu::target{}, {}, options};
+    EXPECT(check_batch(dp, 1));
+    EXPECT(check_batch(dp, 2));
+    EXPECT(check_batch(dp, 1));
+    EXPECT(check_batch(dp, 3));
+    EXPECT(dp.size() == 2);
+    EXPECT(loads == 4);
+    // 2 was the least recently used
+    EXPECT(check_batch(dp, 1));
+    EXPECT(loads == 4);
+    EXPECT(check_batch(dp, 2));
+    EXPECT(loads == 5);
+}
+
+TEST_CASE(dynamic_buckets)
+{
+    std::size_t loads = 0;
+    migraphx::dynamic_options options;
+    options.buckets = {8, 4};
+    migraphx::dynamic_program dp{make_loader(loads), migraphx::cpu::target{}, {}, options};
+    EXPECT(check_batch(dp, 3));
+    EXPECT(check_batch(dp, 4));
+    EXPECT(dp.size() == 1);
+    EXPECT(check_batch(dp, 5));
+    EXPECT(check_batch(dp, 8));
+    EXPECT(dp.size() == 2);
+    EXPECT(check_batch(dp, 9));
+    EXPECT(dp.size() == 3);
+}
+
+TEST_CASE(dynamic_incorrect_shape)
+{
+    std::size_t loads = 0;
+    migraphx::dynamic_program dp{make_loader(loads), migraphx::cpu::target{}};
+    auto eval = [&](const migraphx::shape& s) {
+        return [&dp, s] { dp.eval({{"x", migraphx::generate_argument(s)}}); };
+    };
+    EXPECT(test::throws(eval({migraphx::shape::float_type, {2, 5}})));
+    EXPECT(test::throws(eval({migraphx::shape::float_type, {2, 4, 1}})));
+    EXPECT(test::throws(eval({migraphx::shape::int32_type, {2, 4}})));
+    EXPECT(test::throws([&] { dp.eval({}); }));
+    EXPECT(dp.size() == 0);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
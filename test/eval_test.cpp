@@ -385,6 +385,67 @@ TEST_CASE(target_test)
     EXPECT(result != migraphx::literal{4});
 }
 
+TEST_CASE(modify_after_compile_test)
+{
+    migraphx::program p;
+
+    auto one = p.add_literal(1);
+    auto two = p.add_literal(2);
+    auto sum = p.add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    p.add_instruction(sum_op{}, sum, two);
+    auto result = p.eval({}).back();
+    EXPECT(result == migraphx::literal{5});
+}
+
+TEST_CASE(return_after_compile_test)
+{
+    migraphx::program p;
+
+    auto one  = p.add_literal(1);
+    auto two  = p.add_literal(2);
+    auto sum1 = p.add_instruction(sum_op{}, one, two);
+    auto sum2 = p.add_instruction(sum_op{}, sum1, two);
+    p.add_return({sum2, sum1});
+    p.compile(id_target{});
+    auto results = p.eval({});
+    EXPECT(results.size() == 2);
+    EXPECT(results[0] == migraphx::literal{5});
+    EXPECT(results[1] == migraphx::literal{3});
+}
+
+TEST_CASE(session_test)
+{
+    migraphx::program p;
+
+    auto one = p.add_literal(1);
+    auto two = p.add_parameter("x", {migraphx::shape::int32_type});
+    p.add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    auto s1 = p.create_session();
+    auto s2 = p.create_session();
+    EXPECT(s1.eval({{"x", migraphx::literal{2}.get_argument()}}).back() == migraphx::literal{3});
+    EXPECT(s2.eval({{"x", migraphx::literal{4}.get_argument()}}).back() == migraphx::literal{5});
+    EXPECT(p.eval({{"x", migraphx::literal{1}.get_argument()}}).back() == migraphx::literal{2});
+}
+
+TEST_CASE(session_finalize_test)
+{
+    migraphx::program p;
+    id_target t{};
+    auto one = p.add_literal(1);
+    auto two = p.add_literal(2);
+    p.add_instruction(id_ctx_final_op{}, one, two);
+    p.compile(t);
+    auto ctx = p.get_context();
+    auto s   = p.create_session();
+    EXPECT(s.eval({}).back() == migraphx::literal{1});
+    // The session is finalized with its own context
+    EXPECT(not is_shared(s.get_context(), p.get_context()));
+    EXPECT(is_shared(ctx, p.get_context()));
+}
+
 TEST_CASE(invert_target_test)
 {
     migraphx::program p;
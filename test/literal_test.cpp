@@ -119,4 +119,24 @@ TEST_CASE(literal_visit_empty)
     EXPECT(test::throws([&] { x.visit_at([](auto) {}); }));
 }
 
+TEST_CASE(literal_get_argument_shares_data)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 2}};
+    migraphx::literal x{s, {1, 2, 3, 4}};
+    auto a = x.get_argument();
+    EXPECT(a.data() == x.data());
+    EXPECT(a.get_shape() == s);
+}
+
+TEST_CASE(literal_external_data)
+{
+    migraphx::shape s{migraphx::shape::int32_type, {3}};
+    std::vector<int> data = {1, 2, 3};
+    migraphx::literal x{
+        s, std::shared_ptr<char>(reinterpret_cast<char*>(data.data()), [](char*) {})};
+    EXPECT(x.data() == reinterpret_cast<char*>(data.data()));
+    EXPECT(x == migraphx::literal{s, {1, 2, 3}});
+    EXPECT(x.get_argument().data() == x.data());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,193 @@
+#include <migraphx/load_save.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/operators.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <test.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <dirent.h>
+#include <unistd.h>
+
+migraphx::program create_program()
+{
+    migraphx::program p;
+    migraphx::shape xs{migraphx::shape::float_type, {2, 3, 4, 4}};
+    migraphx::shape ws{migraphx::shape::float_type, {4, 3, 3, 3}};
+    migraphx::shape ds{migraphx::shape::float_type, {6, 16}};
+    auto x    = p.add_parameter("x", xs);
+    auto w    = p.add_literal(migraphx::generate_literal(ws, 1));
+    auto conv = p.add_instruction(migraphx::op::convolution{{{1, 1}}, {{1, 1}}}, x, w);
+    auto relu = p.add_instruction(migraphx::op::relu{}, conv);
+    auto flat = p.add_instruction(migraphx::op::reshape{{8, 16}}, relu);
+    auto d    = p.add_literal(migraphx::generate_literal(ds, 2));
+    auto dt   = p.add_instruction(migraphx::op::transpose{{1, 0}}, d);
+    auto dot  = p.add_instruction(migraphx::op::dot{}, flat, dt);
+    p.add_instruction(migraphx::op::softmax{1}, dot);
+    return p;
+}
+
+TEST_CASE(save_load_program)
+{
+    auto p1 = create_program();
+    auto p2 = migraphx::load_buffer(migraphx::save_buffer(p1));
+    EXPECT(p1 == p2);
+    EXPECT(p2.get_target_name().empty());
+}
+
+TEST_CASE(save_load_nested_operations)
+{
+    migraphx::program p1;
+    migraphx::shape xs{migraphx::shape::float_type, {3, 2, 4}};
+    migraphx::shape ws{migraphx::shape::float_type, {1, 9, 4}};
+    migraphx::shape rs{migraphx::shape::float_type, {1, 9, 3}};
+    auto x = p1.add_parameter("x", xs);
+    auto w = p1.add_literal(migraphx::generate_literal(ws, 1));
+    auto r = p1.add_literal(migraphx::generate_literal(rs, 2));
+    p1.add_instruction(
+        migraphx::op::gru{3,
+                          {migraphx::op::sigmoid{}, migraphx::op::tanh{}},
+                          migraphx::op::rnn_direction::forward,
+                          0.5f,
+                          1},
+        x,
+        w,
+        r);
+    auto p2 = migraphx::load_buffer(migraphx::save_buffer(p1));
+    EXPECT(p1 == p2);
+    auto&& gru = migraphx::any_cast<migraphx::op::gru>(std::prev(p2.end())->get_operator());
+    EXPECT(gru.actv_funcs.size() == 2);
+    EXPECT(gru.actv_funcs[1].name() == "tanh");
+}
+
+TEST_CASE(save_load_compiled_program)
+{
+    auto p1 = create_program();
+    p1.compile(migraphx::cpu::target{});
+    auto buffer = migraphx::save_buffer(p1);
+    // The literal data starts on a page boundary
+    EXPECT(buffer.size() % 4096 == 0);
+    auto p2 = migraphx::load_buffer(buffer);
+    EXPECT(p1 == p2);
+    EXPECT(p2.get_target_name() == "cpu");
+
+    migraphx::program::parameter_map m;
+    m["x"]      = migraphx::generate_argument(p1.get_parameter_shape("x"), 3);
+    std::vector<float> result;
+    std::vector<float> gold;
+    p2.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    p1.eval(m).back().visit([&](auto output) { gold.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(result, gold));
+}
+
+TEST_CASE(load_invalid_buffer)
+{
+    std::vector<char> buffer(64, 'x');
+    EXPECT(test::throws([&] { migraphx::load_buffer(buffer); }));
+    auto saved = migraphx::save_buffer(create_program());
+    saved.resize(saved.size() / 2);
+    EXPECT(test::throws([&] { migraphx::load_buffer(saved); }));
+}
+
+struct cache_dir
+{
+    std::string path;
+    cache_dir()
+    {
+        std::string tmpl = "/tmp/migraphx-cache-XXXXXX";
+        path             = mkdtemp(&tmpl[0]);
+    }
+    cache_dir(const cache_dir&) = delete;
+    cache_dir& operator=(const cache_dir&) = delete;
+    ~cache_dir()
+    {
+        for(auto&& f : files())
+            std::remove((path + "/" + f).c_str());
+        rmdir(path.c_str());
+    }
+
+    std::vector<std::string> files() const
+    {
+        std::vector<std::string> result;
+        DIR* d = opendir(path.c_str());
+        while(auto* e = readdir(d))
+        {
+            std::string name = e->d_name;
+            if(name != "." and name != "..")
+                result.push_back(name);
+        }
+        closedir(d);
+        return result;
+    }
+};
+
+// Compile the program with the cache, and return whether it was compiled
+bool compile_cached(migraphx::program& p, const migraphx::compile_options& options)
+{
+    std::stringstream ss;
+    auto opts  = options;
+    opts.trace = migraphx::tracer{ss};
+    p.compile(migraphx::cpu::target{}, opts);
+    return not ss.str().empty();
+}
+
+TEST_CASE(compile_cache_hit)
+{
+    cache_dir dir;
+    migraphx::compile_options options;
+    options.cache_dir = dir.path;
+    auto p1           = create_program();
+    EXPECT(compile_cached(p1, options));
+    EXPECT(dir.files().size() == 1);
+
+    auto p2 = create_program();
+    EXPECT(not compile_cached(p2, options));
+    EXPECT(p1 == p2);
+    EXPECT(p2.get_target_name() == "cpu");
+
+    migraphx::program::parameter_map m;
+    m["x"] = migraphx::generate_argument(p1.get_parameter_shape("x"), 3);
+    std::vector<float> result;
+    std::vector<float> gold;
+    p2.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    p1.eval(m).back().visit([&](auto output) { gold.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(result, gold));
+
+    // Other options are a miss
+    auto p3              = create_program();
+    options.offload_copy = true;
+    EXPECT(compile_cached(p3, options));
+    EXPECT(dir.files().size() == 2);
+}
+
+TEST_CASE(compile_cache_invalid_file)
+{
+    cache_dir dir;
+    migraphx::compile_options options;
+    options.cache_dir = dir.path;
+    auto p1           = create_program();
+    EXPECT(compile_cached(p1, options));
+    auto file = dir.path + "/" + dir.files().front();
+    std::ofstream(file, std::ios::trunc) << "invalid";
+
+    auto p2 = create_program();
+    EXPECT(compile_cached(p2, options));
+    auto p3 = create_program();
+    EXPECT(not compile_cached(p3, options));
+}
+
+TEST_CASE(compile_cache_limit)
+{
+    cache_dir dir;
+    migraphx::compile_options options;
+    options.cache_dir   = dir.path;
+    options.cache_limit = 1;
+    auto p              = create_program();
+    EXPECT(compile_cached(p, options));
+    EXPECT(dir.files().empty());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
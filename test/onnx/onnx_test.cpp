@@ -1606,4 +1606,16 @@ TEST_CASE(variable_batch_leq_zero_test)
     EXPECT(p == prog);
 }
 
+TEST_CASE(variable_batch_map_dims_test)
+{
+    migraphx::onnx_options options;
+    options.map_input_dims["0"] = {4, 3, 16, 16};
+    auto prog = migraphx::parse_onnx("variable_batch_test.onnx", options);
+    EXPECT(prog.get_parameter_shape("0") ==
+           migraphx::shape{migraphx::shape::float_type, {4, 3, 16, 16}});
+    auto dims = prog.get_symbolic_dims();
+    EXPECT(dims.size() == 1);
+    EXPECT(dims.at("0") == std::vector<std::string>{"?", "", "", ""});
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,82 @@
+#include <migraphx/par_for.hpp>
+#include <migraphx/par_dfor.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(par_for_visits_each)
+{
+    std::vector<int> data(1000, 0);
+    migraphx::par_for(data.size(), [&](auto i) { data[i]++; });
+    EXPECT(std::all_of(data.begin(), data.end(), [](int x) { return x == 1; }));
+}
+
+TEST_CASE(par_for_tid)
+{
+    const std::size_t n = 1000;
+    std::vector<std::size_t> tids(n);
+    migraphx::par_for(n, [&](auto i, auto tid) { tids[i] = tid; });
+    auto max_tid = *std::max_element(tids.begin(), tids.end());
+    EXPECT(max_tid < migraphx::get_thread_pool().size());
+    EXPECT(std::is_sorted(tids.begin(), tids.end()));
+}
+
+TEST_CASE(par_for_nested)
+{
+    const std::size_t n = 64;
+    std::vector<std::size_t> data(n * n, 0);
+    migraphx::par_for(n, 1, [&](auto i) {
+        migraphx::par_for(n, 1, [&](auto j) { data[i * n + j] = i * n + j; });
+    });
+    std::vector<std::size_t> expected(n * n);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT(data == expected);
+}
+
+TEST_CASE(par_dfor_visits_each)
+{
+    std::vector<int> data(4 * 5 * 6, 0);
+    migraphx::par_dfor(4, 5, 6)([&](std::size_t i, std::size_t j, std::size_t k) {
+        data[i * 30 + j * 6 + k]++;
+    });
+    EXPECT(std::all_of(data.begin(), data.end(), [](int x) { return x == 1; }));
+}
+
+TEST_CASE(thread_pool_run)
+{
+    migraphx::thread_pool pool{4};
+    EXPECT(pool.size() == 4);
+    EXPECT(not pool.is_worker());
+    std::atomic<std::size_t> sum{0};
+    std::atomic<std::size_t> workers{0};
+    pool.run(1000, 7, [&](std::size_t i) {
+        sum += i;
+        if(pool.is_worker())
+            workers++;
+    });
+    EXPECT(sum == 1000 * 999 / 2);
+    EXPECT(workers <= 1000);
+}
+
+TEST_CASE(thread_pool_exception)
+{
+    migraphx::thread_pool pool{4};
+    std::atomic<std::size_t> count{0};
+    EXPECT(test::throws<std::runtime_error>([&] {
+        pool.run(100, 1, [&](std::size_t i) {
+            count++;
+            if(i == 42)
+                throw std::runtime_error("error");
+        });
+    }));
+    EXPECT(count == 100);
+    // The pool is still usable after a failed job
+    std::atomic<std::size_t> sum{0};
+    pool.run(10, 1, [&](std::size_t i) { sum += i; });
+    EXPECT(sum == 45);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
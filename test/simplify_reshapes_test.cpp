@@ -376,4 +376,112 @@ TEST_CASE(multibroadcast_simplify)
     EXPECT(std::distance(p.begin(), p.end()) == n - 1);
 }
 
+std::vector<float> eval_values(const migraphx::program& p)
+{
+    std::vector<float> result;
+    p.eval({}).back().visit([&](auto output) {
+        for(std::size_t i = 0; i < output.size(); i++)
+            result.push_back(output[i]);
+    });
+    return result;
+}
+
+std::size_t count_transposes(const migraphx::program& p)
+{
+    return std::count_if(p.begin(), p.end(), [](auto ins) { return ins.name() == "transpose"; });
+}
+
+TEST_CASE(pointwise_transpose)
+{
+    migraphx::program p;
+    auto s    = migraphx::shape{migraphx::shape::float_type, {1, 2, 3, 4}};
+    auto x    = p.add_literal(migraphx::generate_literal(s, 1));
+    auto y    = p.add_literal(migraphx::generate_literal(s, 2));
+    auto xt   = p.add_instruction(migraphx::op::transpose{{0, 2, 3, 1}}, x);
+    auto yt   = p.add_instruction(migraphx::op::transpose{{0, 2, 3, 1}}, y);
+    auto add  = p.add_instruction(migraphx::op::add{}, xt, yt);
+    auto relu = p.add_instruction(migraphx::op::relu{}, add);
+    p.add_instruction(migraphx::op::transpose{{0, 3, 1, 2}}, relu);
+    auto result = p.eval({}).back();
+    run_pass(p);
+    EXPECT(count_transposes(p) == 0);
+    EXPECT(p.get_output_shapes().back().standard());
+    EXPECT(p.eval({}).back() == result);
+}
+
+TEST_CASE(pointwise_transpose_broadcast)
+{
+    migraphx::program p;
+    auto s    = migraphx::shape{migraphx::shape::float_type, {1, 2, 3, 4}};
+    auto x    = p.add_literal(migraphx::generate_literal(s, 1));
+    auto b    = p.add_literal(migraphx::generate_literal({migraphx::shape::float_type, {2}}, 2));
+    auto xt   = p.add_instruction(migraphx::op::transpose{{0, 2, 3, 1}}, x);
+    auto xc   = p.add_instruction(migraphx::op::contiguous{}, xt);
+    auto bias = p.add_instruction(migraphx::op::broadcast{3, xt->get_shape().lens()}, b);
+    auto add  = p.add_instruction(migraphx::op::add{}, xc, bias);
+    p.add_instruction(migraphx::op::transpose{{0, 3, 1, 2}}, add);
+    auto result = eval_values(p);
+    run_pass(p);
+    EXPECT(count_transposes(p) == 0);
+    EXPECT(p.get_output_shapes().back().standard());
+    auto bcast =
+        std::find_if(p.begin(), p.end(), [](auto ins) { return ins.name() == "broadcast"; });
+    EXPECT(migraphx::any_cast<migraphx::op::broadcast>(bcast->get_operator()).axis == 1);
+    EXPECT(eval_values(p) == result);
+}
+
+TEST_CASE(pointwise_transpose_multibroadcast)
+{
+    migraphx::program p;
+    auto s   = migraphx::shape{migraphx::shape::float_type, {1, 2, 3, 4}};
+    auto x   = p.add_literal(migraphx::generate_literal(s, 1));
+    auto y   = p.add_literal(migraphx::generate_literal({migraphx::shape::float_type, {4, 1}}, 2));
+    auto xt  = p.add_instruction(migraphx::op::transpose{{0, 2, 3, 1}}, x);
+    auto yb  = p.add_instruction(migraphx::op::multibroadcast{xt->get_shape().lens()}, y);
+    auto mul = p.add_instruction(migraphx::op::mul{}, xt, yb);
+    p.add_instruction(migraphx::op::transpose{{0, 3, 1, 2}}, mul);
+    auto result = eval_values(p);
+    run_pass(p);
+    // Only the broadcasted input is transposed
+    EXPECT(count_transposes(p) == 1);
+    EXPECT(p.get_output_shapes().back().standard());
+    EXPECT(eval_values(p) == result);
+}
+
+TEST_CASE(pointwise_transpose_different)
+{
+    migraphx::program p;
+    auto s   = migraphx::shape{migraphx::shape::float_type, {2, 2, 2}};
+    auto x   = p.add_parameter("x", s);
+    auto xt  = p.add_instruction(migraphx::op::transpose{{0, 2, 1}}, x);
+    auto yt  = p.add_instruction(migraphx::op::transpose{{1, 0, 2}}, x);
+    auto add = p.add_instruction(migraphx::op::add{}, xt, yt);
+    p.add_instruction(pass_op{}, add);
+    auto n = std::distance(p.begin(), p.end());
+    run_pass(p);
+    EXPECT(std::distance(p.begin(), p.end()) == n);
+    EXPECT(count_transposes(p) == 2);
+}
+
+TEST_CASE(reduce_transpose)
+{
+    migraphx::program p;
+    auto s   = migraphx::shape{migraphx::shape::float_type, {1, 2, 3, 4}};
+    auto x   = p.add_literal(migraphx::generate_literal(s, 1));
+    auto xt  = p.add_instruction(migraphx::op::transpose{{0, 2, 3, 1}}, x);
+    auto sum = p.add_instruction(migraphx::op::reduce_sum{{1, 2}}, xt);
+    auto max = p.add_instruction(migraphx::op::reduce_max{{3}}, sum);
+    p.add_instruction(migraphx::op::transpose{{0, 3, 1, 2}}, max);
+    auto result = p.eval({}).back();
+    run_pass(p);
+    EXPECT(count_transposes(p) == 0);
+    auto r = std::find_if(p.begin(), p.end(), [](auto ins) { return ins.name() == "reduce_sum"; });
+    EXPECT(migraphx::any_cast<migraphx::op::reduce_sum>(r->get_operator()).axes ==
+           std::vector<int64_t>{2, 3});
+    auto m = std::find_if(p.begin(), p.end(), [](auto ins) { return ins.name() == "reduce_max"; });
+    EXPECT(migraphx::any_cast<migraphx::op::reduce_max>(m->get_operator()).axes ==
+           std::vector<int64_t>{1});
+    EXPECT(p.eval({}).back() == result);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
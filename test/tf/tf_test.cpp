@@ -691,4 +691,14 @@ TEST_CASE(variable_batch_test)
     EXPECT(p == prog);
 }
 
+TEST_CASE(variable_batch_map_dims_test)
+{
+    migraphx::tf_options options;
+    options.map_input_dims["0"] = {4, 3, 16, 16};
+    auto prog = migraphx::parse_tf("variable_batch_test.pb", options);
+    EXPECT(prog.get_parameter_shape("0") ==
+           migraphx::shape{migraphx::shape::float_type, {4, 3, 16, 16}});
+    EXPECT(prog.get_symbolic_dims().at("0") == std::vector<std::string>{"?", "", "", ""});
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }